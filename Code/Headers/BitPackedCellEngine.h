@@ -0,0 +1,91 @@
+#ifndef GAMEOFLIFE_BITPACKEDCELLENGINE
+#define GAMEOFLIFE_BITPACKEDCELLENGINE
+
+#include <cstdint>
+#include <vector>
+
+#include "CellEngine.h"
+
+//pure CPU engine storing one bit per cell, every row is packed into 64-bit words (bit b of word w is column w*64+b-1),
+//so a single sequence of bitwise full-adder operations calculates 64 cells at once, the board is surrounded by ghost cells
+//(bit 0 and bit columnCount+1 of every row, one whole row above and below the board) filled according to the topology before every generation
+class BitPackedCellEngine : public CellEngine
+{
+public:
+    typedef void (BitPackedCellEngine::*CalculateTileFunction)(int firstRow, int lastRow, int firstWord, int lastWord);
+
+protected:
+    int mColumnCount, mRowCount;
+    int mWordsPerRow;
+    BoardTopology mTopology;
+    LifeRule mRule;
+    CalculateTileFunction mCalculateTile;//instantiation of calculateTileWithRule for the current rule
+
+    std::vector<uint64_t> mInputWords;//row j of the board is row j+1 of the buffer
+    std::vector<uint64_t> mOutputWords;
+    std::vector<uint64_t> mCellMasks;//bits of every word of a row which hold cells instead of ghost cells or padding
+
+public:
+    BitPackedCellEngine();
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void getCells(CellGrid& cellGrid) override;
+    void setTopology(BoardTopology topology) override;
+    void setRule(const LifeRule& rule) override;
+    bool isRuleSupported(const LifeRule& rule) const override;
+
+    std::string getName() const override;
+
+    //next generation of 64 cells given their row and the rows above and below, each also shifted by one column in both directions,
+    //defined here, so every engine working on bit-packed rows gets it inlined into its inner loop
+    template<typename Rule>
+    static uint64_t calculateNextWord(uint64_t aboveWest, uint64_t above, uint64_t aboveEast, uint64_t centerWest, uint64_t center, uint64_t centerEast,
+                                      uint64_t belowWest, uint64_t below, uint64_t belowEast, const LifeRule& rule)
+    {
+        //full adders summing every row of three neighbours, then a tree of adders summing those partial sums
+        uint64_t aboveSum = aboveWest ^ above ^ aboveEast;
+        uint64_t aboveCarry = (aboveWest & above) | (aboveEast & (aboveWest ^ above));
+        uint64_t belowSum = belowWest ^ below ^ belowEast;
+        uint64_t belowCarry = (belowWest & below) | (belowEast & (belowWest ^ below));
+        uint64_t centerSum = centerWest ^ centerEast;
+        uint64_t centerCarry = centerWest & centerEast;
+
+        uint64_t countBit0 = aboveSum ^ belowSum ^ centerSum;
+        uint64_t onesCarry = (aboveSum & belowSum) | (centerSum & (aboveSum ^ belowSum));
+
+        uint64_t twosSum = aboveCarry ^ belowCarry ^ centerCarry;
+        uint64_t twosCarry = (aboveCarry & belowCarry) | (centerCarry & (aboveCarry ^ belowCarry));
+        uint64_t countBit1 = twosSum ^ onesCarry;
+        uint64_t foursCarry = twosSum & onesCarry;
+        uint64_t countBit2 = twosCarry ^ foursCarry;
+        uint64_t countBit3 = twosCarry & foursCarry;
+
+        //every neighbour count used by the rule is matched against the four bits of the count, for static rules
+        //the loop unrolls into just those comparisons (Conway's rule only needs counts 2 and 3)
+        uint64_t nextGeneration = 0;
+        for (int i=0; i<=8; i++)
+        {
+            bool isBirth = (Rule::getBirthMask(rule) >> i) & 1;
+            bool isSurvival = (Rule::getSurvivalMask(rule) >> i) & 1;
+            if (!isBirth && !isSurvival)
+            {
+                continue;
+            }
+            uint64_t isCountEqual = ((i & 1) ? countBit0 : ~countBit0) & ((i & 2) ? countBit1 : ~countBit1)
+                                  & ((i & 4) ? countBit2 : ~countBit2) & ((i & 8) ? countBit3 : ~countBit3);
+            nextGeneration |= isCountEqual & (isBirth ? (isSurvival ? ~(uint64_t)0 : ~center) : center);
+        }
+        return nextGeneration;
+    }
+
+protected:
+    //calculates next generation of the given rectangle of words only, so separate tiles can be processed independently
+    void calculateTile(int firstRow, int lastRow, int firstWord, int lastWord);
+    template<typename Rule>
+    void calculateTileWithRule(int firstRow, int lastRow, int firstWord, int lastWord);
+    //copies cells from the edges of the board into ghost cells on the opposite side, so the hot loop never has to wrap anything
+    void fillGhostCells();
+};
+
+#endif //GAMEOFLIFE_BITPACKEDCELLENGINE
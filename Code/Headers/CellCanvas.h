@@ -1,10 +1,19 @@
 #ifndef GAMEOFLIFE_CELLCANVAS
 #define GAMEOFLIFE_CELLCANVAS
 
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
 #include <SFML/Graphics.hpp>
-#include <CL/cl.hpp>
 
-#include "OpenCLFunctions.h"
+#include "CellGrid.h"
+#include "Simulation.h"
+#include "PatternFile.h"
+#include "CellRenderer.h"
+#include "VertexArrayCellRenderer.h"
+#include "StateTextureCellRenderer.h"
 
 struct TwoValueKey
 {
@@ -32,21 +41,6 @@ struct TwoValueKey
     }
 };
 
-struct OpenCLObject
-{
-    cl::Platform platform;
-    cl::Device device;
-    cl::Context context;
-    cl::Program programCell;
-    cl::CommandQueue commandQueue;
-    cl::Kernel kernelCell;
-    cl::Buffer deviceColumnCount, deviceRowCount, deviceInputCellValues, deviceOutputCellValues;
-
-    cl::NDRange localWorkGroupSize, globalWorkGroupSize;
-
-    int* bufferOutputCellValues;
-};
-
 class CellCanvas
 {
 private:
@@ -55,39 +49,56 @@ private:
     double mTimeSinceLastUpdate;
     double mUpdateInterval;
     int mUpdateIntervalDivider;
+    bool mIsBatchedUpdateEnabled;
+    double mAverageGenerationTime;
 
-    sf::Texture mDeadCellTexture;
-    sf::Texture mAliveCellTexture;
+    //dead cell image on the left and alive cell image on the right, so all cells can be drawn with one texture in one draw call
+    sf::Texture mCellAtlasTexture;
 
-    std::map<TwoValueKey, int> mMapOfCells;
-    std::map<TwoValueKey, sf::Sprite> mMapOfSprites;
+    Simulation mSimulation;
+    sf::Vector2f mCanvasOrigin;
+    float mCellSize;
+    sf::Transform mViewTransform;//zoom and pan applied on top of the canvas
 
-    OpenCLObject mOpenCLObject;
+    std::unique_ptr<CellRenderer> mCellRenderer;
+    bool mIsStateTextureRendererEnabled;
 
 public:
-    CellCanvas(int screenWidth, int screenHeight, int columnCount, int rowCount);
+    CellCanvas(int screenWidth, int screenHeight, int columnCount, int rowCount, const LifeRule& rule = LifeRule::conway());
 
     ~CellCanvas();
 
     TwoValueKey getCellByPositionOnScreen(sf::Vector2<int> position);
 
-    void switchCellState(TwoValueKey cell);
+    int switchCellState(TwoValueKey cell);
+    void setCellStatesAlongLine(sf::Vector2<int> beginPosition, sf::Vector2<int> endPosition, int cellValue);
     void addColumn();
     void addRow();
     void removeColumn();
     void removeRow();
     void speedUpUpdateInterval();
     void slowDownUpdateInterval();
-
-    void update(double deltaTime);
+    void switchCellEngine();
+    void switchBatchedUpdate();
+    void switchCellRenderer();
+    void switchTopology();
+    //board grows to fit the whole pattern, but never shrinks
+    void placePattern(const CellGrid& pattern);
+    void savePattern(const std::string& filepath);
+    void zoomView(float factor, sf::Vector2<int> position);
+    void panView(sf::Vector2<int> offset);
+    void resetView();
+
+    void update(double deltaTime, double frameTime);
 
     void draw(sf::RenderWindow &window);
 
 private:
-    void updateCells();
-    void updateSpritesToMatchCellStates();
-    void updateCellsAndSpritesToMatchColumnsAndRows();
-    void updateOpenCLObjectToMatchColumnsAndRows();
+    sf::Vector2<int> getUnboundedCellByPositionOnScreen(sf::Vector2<int> position);
+    void setCellState(int column, int row, int cellValue);
+    void updateCells(int generationCount);
+    void synchronizeCellGridWithEngine();
+    void updateCellsAndRendererToMatchColumnsAndRows();
 };
 
 #endif //GAMEOFLIFE_CELLCANVAS
\ No newline at end of file
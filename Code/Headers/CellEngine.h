@@ -0,0 +1,44 @@
+#ifndef GAMEOFLIFE_CELLENGINE
+#define GAMEOFLIFE_CELLENGINE
+
+#include <string>
+
+#include "CellGrid.h"
+#include "LifeRule.h"
+
+//how cells on the edges of the board are connected to the cells on the opposite edges
+enum class BoardTopology
+{
+    deadBorder,//cells outside the board are always dead
+    torus,//left edge is joined with the right one and top edge with the bottom one
+    kleinBottle//same as torus, but the top edge is joined with the bottom one reversed (column c meets column columnCount-1-c)
+};
+
+//common interface of everything capable of calculating new generations of cells,
+//engines keep their own (possibly device resident or packed) copy of the board between calls
+class CellEngine
+{
+public:
+    virtual ~CellEngine() = default;
+
+    //replaces the state kept by the engine with the contents (and size) of the given grid
+    virtual void setCells(const CellGrid& cellGrid) = 0;
+    virtual void calculateNextGenerations(int generationCount) = 0;
+    //blocks until all generations requested so far are calculated, only asynchronous engines have to override it
+    virtual void finish() {}
+    //writes current state kept by the engine into the given grid, resizing it if necessary
+    virtual void getCells(CellGrid& cellGrid) = 0;
+    //takes effect with the next call to setCells, engines simulating an unbounded universe have no edges and ignore it
+    virtual void setTopology(BoardTopology topology) {}
+    //same as topology, rule is only guaranteed to take effect with the next call to setCells
+    virtual void setRule(const LifeRule& rule) = 0;
+    //engines storing a single bit per cell cannot simulate dying states of Generations rules, and most engines only count the 8 cells around
+    //(so no Larger than Life rules)
+    virtual bool isRuleSupported(const LifeRule& rule) const { return true; }
+    //engines simulating an unbounded universe have no edges to join, so they only accept the default dead border
+    virtual bool isTopologySupported(BoardTopology topology) const { return true; }
+
+    virtual std::string getName() const = 0;
+};
+
+#endif //GAMEOFLIFE_CELLENGINE
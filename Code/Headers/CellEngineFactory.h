@@ -0,0 +1,23 @@
+#ifndef GAMEOFLIFE_CELLENGINEFACTORY
+#define GAMEOFLIFE_CELLENGINEFACTORY
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CellEngine.h"
+
+//creates engines by their short identifiers (for example "simd" or "opencl-local"), so the interactive front end and the headless driver
+//offer exactly the same engines without either of them knowing their classes
+class CellEngineFactory
+{
+public:
+    //identifiers of all engines usable on this machine, in the order they are offered, OpenCL ones only if there is a usable platform
+    static std::vector<std::string> getEngineIds();
+    //returns nullptr for unknown identifiers
+    static std::unique_ptr<CellEngine> createEngine(const std::string& engineId);
+    //every usable engine able to simulate the rule, already set up with it and the topology, engines which are not able to are reported on the standard output
+    static std::vector<std::unique_ptr<CellEngine>> createEnginesForRule(const LifeRule& rule, BoardTopology topology);
+};
+
+#endif //GAMEOFLIFE_CELLENGINEFACTORY
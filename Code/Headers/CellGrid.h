@@ -0,0 +1,48 @@
+#ifndef GAMEOFLIFE_CELLGRID
+#define GAMEOFLIFE_CELLGRID
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//dense column-major buffer of cell values (states of at most LifeRule::maximumStateCount, so a byte per cell), laid out exactly like the arrays the OpenCL kernels work on,
+//so it can be uploaded to and read back from the device without any conversion, columns and rows are allocated with spare capacity,
+//so repeatedly adding them keeps existing cells and only occasionally moves the whole buffer
+class CellGrid
+{
+private:
+    int mColumnCount, mRowCount;
+    int mColumnStride;//distance (in cells) between the first cells of two neighbouring columns, so also the row capacity
+    int mColumnCapacity;
+
+    std::vector<uint8_t> mCellValues;
+
+public:
+    CellGrid(int columnCount, int rowCount);
+
+    int getColumnCount() const { return mColumnCount; }
+    int getRowCount() const { return mRowCount; }
+    int getColumnStride() const { return mColumnStride; }
+
+    bool containsCell(int column, int row) const
+    {
+        return column >= 0 && row >= 0 && column < mColumnCount && row < mRowCount;
+    }
+
+    int getCellValue(int column, int row) const { return mCellValues[(size_t)column*mColumnStride+row]; }
+    void setCellValue(int column, int row, int value) { mCellValues[(size_t)column*mColumnStride+row] = (uint8_t)value; }
+
+    uint8_t* getData() { return mCellValues.data(); }
+    const uint8_t* getData() const { return mCellValues.data(); }
+    size_t getDataSize() const;
+
+    //keeps cells which are still on the board, new cells are dead
+    void resize(int columnCount, int rowCount);
+    void clear();
+
+private:
+    void clearCells(int firstColumn, int lastColumn, int firstRow, int lastRow);
+};
+
+#endif //GAMEOFLIFE_CELLGRID
@@ -0,0 +1,39 @@
+#ifndef GAMEOFLIFE_CELLRENDERER
+#define GAMEOFLIFE_CELLRENDERER
+
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "CellGrid.h"
+
+//common interface of everything capable of drawing the board, renderers keep whatever they need to draw cells between frames
+//and are told about changed cells, so nothing has to be rebuilt from scratch every frame
+class CellRenderer
+{
+public:
+    virtual ~CellRenderer() = default;
+
+    //prepares drawing of a board of the given size, with its top left corner at canvasOrigin and every cell being cellSize pixels wide
+    virtual void setCanvasGeometry(int columnCount, int rowCount, sf::Vector2f canvasOrigin, float cellSize) = 0;
+    virtual void updateCells(const CellGrid& cellGrid) = 0;
+    virtual void updateCell(const CellGrid& cellGrid, int column, int row) = 0;
+
+    //transform is applied on top of the canvas geometry, so zooming and panning never requires rebuilding anything
+    virtual void draw(sf::RenderWindow& window, const sf::Transform& transform) = 0;
+
+    virtual std::string getName() const = 0;
+
+    //dead and living cells are drawn as they are, dying states of Generations rules (2 to stateCount-1) are drawn as living cells
+    //fading to a quarter of their brightness, Resources/Shaders/cellState.frag uses the same formula
+    static float getCellBrightness(int cellValue, int stateCount)
+    {
+        if (cellValue <= 1)
+        {
+            return 1.0f;
+        }
+        return 1.0f-0.75f*(float)(cellValue-1)/(float)(stateCount-1);
+    }
+};
+
+#endif //GAMEOFLIFE_CELLRENDERER
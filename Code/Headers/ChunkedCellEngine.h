@@ -0,0 +1,53 @@
+#ifndef GAMEOFLIFE_CHUNKEDCELLENGINE
+#define GAMEOFLIFE_CHUNKEDCELLENGINE
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "CellEngine.h"
+
+//bit-packed engine without any borders, the plane is split into 64x64 chunks kept in a hash map, chunks are allocated once living cells
+//reach their edge and freed once everything in them dies, so gliders and spaceships can travel away indefinitely while memory stays
+//proportional to the living area, the cell grid passed to setCells/getCells is only a window onto the plane placed at coordinates (0, 0)
+class ChunkedCellEngine : public CellEngine
+{
+public:
+    static constexpr int chunkSize = 64;
+    //row j of a chunk is a single word, bit i of it is column i of the chunk
+    using Chunk = std::array<uint64_t, chunkSize>;
+    typedef void (ChunkedCellEngine::*CalculateChunkFunction)(uint64_t chunkKey, Chunk& nextChunk) const;
+
+private:
+    std::unordered_map<uint64_t, Chunk> mChunks;
+    std::unordered_map<uint64_t, Chunk> mNextChunks;
+    std::vector<uint64_t> mGrownChunkKeys;
+
+    int mColumnCount, mRowCount;
+    LifeRule mRule;
+    CalculateChunkFunction mCalculateChunk;//instantiation of calculateChunk for the current rule
+
+public:
+    ChunkedCellEngine();
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void getCells(CellGrid& cellGrid) override;
+    void setRule(const LifeRule& rule) override;
+    bool isRuleSupported(const LifeRule& rule) const override;
+    bool isTopologySupported(BoardTopology topology) const override;
+
+    std::string getName() const override;
+
+    size_t getChunkCount() const;
+
+private:
+    void calculateNextGeneration();
+    void growChunksAroundLivingEdges();
+    template<typename Rule>
+    void calculateChunk(uint64_t chunkKey, Chunk& nextChunk) const;
+    const Chunk* findChunk(int chunkColumn, int chunkRow) const;
+};
+
+#endif //GAMEOFLIFE_CHUNKEDCELLENGINE
@@ -2,7 +2,6 @@
 #define GAMEOFLIFE_GAME
 
 #include <chrono>
-#include <wtypes.h>
 #include <thread>
 
 #include <SFML/Graphics.hpp>
@@ -27,8 +26,16 @@ class Game
 
     bool mIsPaused;
 
+    //cells are painted as long as the left mouse button is held, with the state the first clicked cell was switched to
+    bool mIsPainting;
+    int mPaintedCellValue;
+    sf::Vector2<int> mLastPaintingPosition;
+    bool mIsPanning;
+    sf::Vector2<int> mLastPanningPosition;
+
 public:
-    Game();
+    //pattern is optional, the board starts empty without it
+    explicit Game(const LifeRule& rule = LifeRule::conway(), const CellGrid* pattern = nullptr);
 
 private:
     void gameLoop();
@@ -0,0 +1,92 @@
+#ifndef GAMEOFLIFE_HASHLIFEENGINE
+#define GAMEOFLIFE_HASHLIFEENGINE
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "CellEngine.h"
+
+//memoized quadtree engine (HashLife), every distinct square of cells is stored only once in a canonical hash table together with
+//its already calculated future, so repetitive patterns can be advanced by 2^k generations at once, the universe is unbounded
+//and the cell grid passed to setCells/getCells is only a window onto it placed at coordinates (0, 0)
+class HashLifeEngine : public CellEngine
+{
+public:
+    static constexpr uint32_t noNode = 0xFFFFFFFF;
+    static constexpr uint32_t deadLeaf = 0;
+    static constexpr uint32_t aliveLeaf = 1;
+
+    struct Node
+    {
+        uint32_t nw, ne, sw, se;//children, or noNode for leaves (single cells)
+        uint32_t result;//center half of this square after 2^(level-2) generations, noNode until calculated
+        uint32_t nextInBucket;
+        uint64_t population;
+        int level;//node covers a square of 2^level x 2^level cells
+    };
+
+private:
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mBuckets;
+    std::vector<uint32_t> mEmptyNodes;//one per level, created lazily
+    //center halves after 2^stepExponent generations of squares too large for a full step, by node and step exponent (node << 8 | exponent),
+    //kept apart from full step results so switching between step sizes does not throw any of them away
+    std::unordered_map<uint64_t, uint32_t> mPartialResults;
+
+    uint32_t mRoot;//centered on coordinates (0, 0), so it covers cells from -2^(level-1) to 2^(level-1)-1 in both directions
+    int mStepExponent;
+    uint64_t mGenerationCount;
+    size_t mGarbageCollectionThreshold;
+
+    int mColumnCount, mRowCount;
+    LifeRule mRule;
+
+public:
+    HashLifeEngine();
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void getCells(CellGrid& cellGrid) override;
+    void setRule(const LifeRule& rule) override;
+    bool isRuleSupported(const LifeRule& rule) const override;
+    bool isTopologySupported(BoardTopology topology) const override;
+
+    std::string getName() const override;
+
+    //advances the whole universe by 2^exponent generations in a single call
+    void advanceByPowerOfTwo(int exponent);
+    //same as calculateNextGenerations, but for runs of far more generations than an int holds
+    void advanceByGenerations(uint64_t generationCount);
+
+    uint64_t getGenerationCount() const;
+    uint64_t getPopulation() const;
+    size_t getNodeCount() const;
+
+    //low level access used when building and saving whole quadtrees (for example macrocell files)
+    uint32_t createNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t createEmptyNode(int level);
+    const Node& getNode(uint32_t node) const;
+    uint32_t getRoot() const;
+    void setRoot(uint32_t root);
+    //generation the universe is at, such as the one saved with a macrocell file, advancing adds to it
+    void setGenerationCount(uint64_t generationCount);
+    void clear();
+    void collectGarbage();
+
+private:
+    uint32_t calculateResult(uint32_t node);
+    uint32_t calculateBaseResult(uint32_t node);
+    uint32_t createCenteredSubnode(uint32_t node);
+    uint32_t createCenteredHorizontalSubnode(uint32_t west, uint32_t east);
+    uint32_t createCenteredVerticalSubnode(uint32_t north, uint32_t south);
+    uint32_t expandUniverse(uint32_t node);
+    bool isPopulationInCenterQuarter(uint32_t node);
+    uint32_t buildNodeFromGrid(const CellGrid& cellGrid, int level, int64_t x, int64_t y);
+    void writeNodeToGrid(CellGrid& cellGrid, uint32_t node, int64_t x, int64_t y);
+    void setStepExponent(int exponent);
+    void clearResults();
+    void rehash(size_t bucketCount);
+};
+
+#endif //GAMEOFLIFE_HASHLIFEENGINE
@@ -0,0 +1,120 @@
+#ifndef GAMEOFLIFE_LIFERULE
+#define GAMEOFLIFE_LIFERULE
+
+#include <cstdint>
+#include <string>
+
+//cells counted as neighbours of the cell in the middle, within range cells in every direction
+enum class LifeNeighbourhood
+{
+    moore,//square of (2*range+1)x(2*range+1) cells
+    vonNeumann//diamond of cells at most range steps away horizontally plus vertically
+};
+
+//outer-totalistic rule of a Life-like automaton in B/S notation (Conway's Game of Life is B3/S23),
+//bit n of a mask is set if a dead cell with n living neighbours is born, or a living cell with n living neighbours survives,
+//Generations rules (B/S/C notation, for example Brian's Brain B2/S/C3) add dying states: living cell which does not survive
+//goes through states 2, 3, ..., stateCount-1 one generation at a time before it is dead (state 0), only living cells (state 1) count as neighbours,
+//Larger than Life rules (for example Bosco's rule R5,C0,M1,S34..58,B34..45,NM) count neighbours in a larger range or in a von Neumann neighbourhood,
+//their birth and survival counts are intervals instead of masks (range 1 Moore rules are always stored as masks)
+struct LifeRule
+{
+    uint16_t birthMask;
+    uint16_t survivalMask;
+    int stateCount;//2 for Life-like rules, at most maximumStateCount
+
+    int range = 1;
+    LifeNeighbourhood neighbourhood = LifeNeighbourhood::moore;
+    //only used with an extended neighbourhood, the cell itself is never counted, empty if minimum is greater than maximum
+    int birthMinimum = 0, birthMaximum = 0;
+    int survivalMinimum = 0, survivalMaximum = 0;
+
+    static constexpr int maximumStateCount = 256;
+    static constexpr int maximumRange = 100;
+
+    static LifeRule conway();
+    //accepts "B3/S23" or "B2/S345/C4" as well as the older "23/3" or "345/2/4" (survival first) notation in any letter case,
+    //Larger than Life rules are written as "R5,C0,M1,S34..58,B34..45,NM" (C, M and N may be left out),
+    //rules with B0 are accepted, but only engines with a bounded board support them
+    static bool parse(const std::string& ruleString, LifeRule& rule);
+    std::string toString() const;
+
+    bool isBirth(int livingNeighboursCount) const
+    {
+        if (hasExtendedNeighbourhood())
+        {
+            return livingNeighboursCount >= birthMinimum && livingNeighboursCount <= birthMaximum;
+        }
+        return (birthMask >> livingNeighboursCount) & 1;
+    }
+    bool isSurvival(int livingNeighboursCount) const
+    {
+        if (hasExtendedNeighbourhood())
+        {
+            return livingNeighboursCount >= survivalMinimum && livingNeighboursCount <= survivalMaximum;
+        }
+        return (survivalMask >> livingNeighboursCount) & 1;
+    }
+
+    bool isGenerations() const { return stateCount > 2; }
+    //anything else than the 8 cells around, which every engine supports
+    bool hasExtendedNeighbourhood() const { return range > 1 || neighbourhood != LifeNeighbourhood::moore; }
+    int getNeighbourCount() const;
+
+    bool operator==(const LifeRule& other) const
+    {
+        return birthMask == other.birthMask && survivalMask == other.survivalMask && stateCount == other.stateCount && range == other.range && neighbourhood == other.neighbourhood
+            && birthMinimum == other.birthMinimum && birthMaximum == other.birthMaximum && survivalMinimum == other.survivalMinimum && survivalMaximum == other.survivalMaximum;
+    }
+};
+
+//rule known at compile time, engines instantiated with it get every mask test folded away, so it runs exactly as fast as hard-coded rules
+template<uint16_t birthMaskValue, uint16_t survivalMaskValue, int stateCountValue = 2>
+struct StaticLifeRule
+{
+    static uint16_t getBirthMask(const LifeRule&) { return birthMaskValue; }
+    static uint16_t getSurvivalMask(const LifeRule&) { return survivalMaskValue; }
+    static int getStateCount(const LifeRule&) { return stateCountValue; }
+};
+
+//any other rule, masks are read at runtime
+struct DynamicLifeRule
+{
+    static uint16_t getBirthMask(const LifeRule& rule) { return rule.birthMask; }
+    static uint16_t getSurvivalMask(const LifeRule& rule) { return rule.survivalMask; }
+    static int getStateCount(const LifeRule& rule) { return rule.stateCount; }
+};
+
+//calls selector with an instance of the static rule matching the given one (Conway's Game of Life and other well known rules),
+//or of the dynamic rule if there is none, engines use it to pick the template instantiation of their inner loop once per rule change
+template<typename Selector>
+auto selectLifeRule(const LifeRule& rule, Selector selector)
+{
+    if (rule == LifeRule{1 << 3, (1 << 2) | (1 << 3), 2})
+    {
+        return selector(StaticLifeRule<1 << 3, (1 << 2) | (1 << 3)>());//B3/S23, Conway's Game of Life
+    }
+    if (rule == LifeRule{(1 << 3) | (1 << 6), (1 << 2) | (1 << 3), 2})
+    {
+        return selector(StaticLifeRule<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)>());//B36/S23, HighLife
+    }
+    if (rule == LifeRule{(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8), 2})
+    {
+        return selector(StaticLifeRule<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8), (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)>());//B3678/S34678, Day & Night
+    }
+    if (rule == LifeRule{1 << 2, 0, 2})
+    {
+        return selector(StaticLifeRule<1 << 2, 0>());//B2/S, Seeds
+    }
+    if (rule == LifeRule{1 << 2, 0, 3})
+    {
+        return selector(StaticLifeRule<1 << 2, 0, 3>());//B2/S/C3, Brian's Brain
+    }
+    if (rule == LifeRule{1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4})
+    {
+        return selector(StaticLifeRule<1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4>());//B2/S345/C4, Star Wars
+    }
+    return selector(DynamicLifeRule());
+}
+
+#endif //GAMEOFLIFE_LIFERULE
@@ -0,0 +1,29 @@
+#ifndef GAMEOFLIFE_MACROCELLFILE
+#define GAMEOFLIFE_MACROCELLFILE
+
+#include <cstdint>
+#include <string>
+
+#include "CellGrid.h"
+#include "HashLifeEngine.h"
+
+//reads and writes macrocell files (.mc), which store a pattern as a quadtree with every distinct square listed only once, children before parents:
+//8x8 squares as lines of '.' (dead), '*' (living) and '$' (end of row), larger squares as "level nw ne sw se" where children are 1-based line numbers
+//(0 for an empty square), Generations patterns use level 1 squares of four cell states instead of 8x8 ones,
+//the center of the last (top) square is the origin of the universe, just like for the HashLife engine
+class MacrocellFile
+{
+public:
+    static bool isMacrocell(const std::string& filepath);
+
+    //replaces the whole universe of the engine, so patterns far too large for any dense board can be loaded, rule is only changed if the file names one
+    static bool load(const std::string& filepath, HashLifeEngine& hashLifeEngine, LifeRule& rule);
+    //rasterizes the bounding box of all living cells, the grid is resized to it
+    static bool load(const std::string& filepath, CellGrid& cellGrid, LifeRule& rule);
+    //rasterizes the window of the size of the grid, with its top left cell at the given coordinates of the universe
+    static bool loadWindow(const std::string& filepath, int64_t left, int64_t top, CellGrid& cellGrid, LifeRule& rule);
+
+    static bool save(const std::string& filepath, const HashLifeEngine& hashLifeEngine, const LifeRule& rule);
+};
+
+#endif //GAMEOFLIFE_MACROCELLFILE
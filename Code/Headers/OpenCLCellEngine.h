@@ -0,0 +1,74 @@
+#ifndef GAMEOFLIFE_OPENCLCELLENGINE
+#define GAMEOFLIFE_OPENCLCELLENGINE
+
+#include <cstdint>
+#include <vector>
+
+#include <CL/cl.hpp>
+
+#include "CellEngine.h"
+#include "OpenCLFunctions.h"
+
+struct OpenCLObject
+{
+    cl::Platform platform;
+    cl::Device device;
+    cl::Context context;
+    cl::Program programCell;
+    cl::CommandQueue commandQueue;
+    cl::Kernel kernelCell;
+    cl::Buffer deviceColumnCount, deviceRowCount, deviceColumnStride, deviceTopology, deviceInputCellValues, deviceOutputCellValues;
+    //only used by Larger than Life rules, which calculate sums of living cells before every generation, area sums for Moore neighbourhoods
+    //and diagonal sums for von Neumann ones
+    cl::Kernel kernelColumnSums, kernelAreaSums, kernelDiagonalSums;
+    cl::Buffer deviceColumnSums, deviceAreaSums, deviceDiagonalSums, deviceAntiDiagonalSums;
+
+    cl::NDRange localWorkGroupSize, globalWorkGroupSize;
+};
+
+//kernels from Resources/Kernels/cell.txt calculating the same generations in different ways
+enum class OpenCLKernelVariant
+{
+    globalMemory,//every work item reads its neighbours straight from global memory, or from sums of living cells for Larger than Life rules
+    localMemory,//every workgroup loads its tile with a halo into local memory first
+    bitPacked//cells are stored as bits of 32-bit words, every work item calculates a whole word
+};
+
+class OpenCLCellEngine : public CellEngine
+{
+private:
+    int mColumnCount, mRowCount;
+    int mColumnStride;//in cells, or in words for the bit-packed kernel
+    size_t mDeviceCellBufferCapacity;//cell buffers are only reallocated once the board outgrows them
+    size_t mDeviceSumBufferCapacity;//same for both buffers of sums, in bytes
+    OpenCLKernelVariant mKernelVariant;
+    BoardTopology mTopology;
+    LifeRule mRule;
+    int mWordsPerColumn;
+    std::vector<uint32_t> mPackedCellValues;//host side staging buffer for the bit-packed kernel only
+    std::vector<uint8_t> mStagingCellValues;//only used when the grid to read cells into is laid out differently than the device buffer
+
+    OpenCLObject mOpenCLObject;
+
+public:
+    explicit OpenCLCellEngine(OpenCLKernelVariant kernelVariant = OpenCLKernelVariant::globalMemory);
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void finish() override;
+    void getCells(CellGrid& cellGrid) override;
+    void setTopology(BoardTopology topology) override;
+    void setRule(const LifeRule& rule) override;
+    bool isRuleSupported(const LifeRule& rule) const override;
+
+    std::string getName() const override;
+
+private:
+    size_t getDeviceCellBufferSize() const;
+    bool isLargerThanLifeKernelUsed() const;
+    int getVonNeumannRowsPerWorkItem() const;
+    void buildProgramForRule();
+    void updateOpenCLObjectToMatchColumnsAndRows(int gridColumnStride);
+};
+
+#endif //GAMEOFLIFE_OPENCLCELLENGINE
@@ -11,14 +11,19 @@
 class OpenCLFunctions
 {
 public:
+    static bool isOpenCLAvailable();
     static std::vector<cl::Platform> getAllPlatforms();
     static std::vector<cl::Device> getAllDevicesOnPlatform(cl::Platform platform);
     static std::vector<cl::Device> getAllDevicesOnAllPlatforms();
-    static cl::Program buildProgramFromFile(cl::Device& device, cl::Context& context, const std::string& programFilepath);
+    //build options are passed straight to the OpenCL compiler, for example "-D name=value" defines, compiled programs are cached on disk
+    //(in programBinaryCacheDirectory), so following launches with the same device, driver, build options and source only load the binary
+    static cl::Program buildProgramFromFile(cl::Device& device, cl::Context& context, const std::string& programFilepath, const std::string& buildOptions = "");
 
     static void allocateMemoryOnDevice(cl::Buffer& deviceMemory, size_t dataArraySize, cl::Context& context);
 
     static cl::Kernel createKernelForProgram(const std::string& kernelName, cl::Program& program, std::vector<cl::Buffer> arguments);
+    static void setKernelArguments(cl::Kernel& kernel, int firstArgumentIndex, std::vector<cl::Buffer> arguments);
+    static void setKernelLocalMemoryArgument(cl::Kernel& kernel, int argumentIndex, size_t localMemorySize);
 
     static void sendDataToDevice(void* hostData, cl::Buffer deviceData, size_t dataArraySize, cl::CommandQueue& commandQueue);
     static void getDataFromDevice(void* hostData, cl::Buffer deviceData, size_t dataArraySize, cl::CommandQueue& commandQueue);
@@ -28,6 +33,12 @@ public:
 
     static void startKernel(cl::Kernel& kernel, cl::CommandQueue& commandQueue, cl::NDRange localWorkGroupSize, cl::NDRange globalWorkGroupSize);
 
+private:
+    static std::string getProgramCacheKey(cl::Device& device, const std::string& programSource, const std::string& buildOptions);
+    static std::string getProgramCacheFilepath(const std::string& programCacheKey);
+    //returns false if there is no valid binary for the key, the program has to be built from source then
+    static bool loadProgramFromCache(cl::Device& device, cl::Context& context, const std::string& programCacheKey, const std::string& buildOptions, cl::Program& program);
+    static void saveProgramToCache(cl::Program& program, const std::string& programCacheKey);
 };
 
 
@@ -0,0 +1,31 @@
+#ifndef GAMEOFLIFE_PATTERNFILE
+#define GAMEOFLIFE_PATTERNFILE
+
+#include <string>
+
+#include "CellGrid.h"
+#include "LifeRule.h"
+
+//reads and writes patterns, the format is chosen by the file extension:
+//- run length encoded (.rle), rows of runs such as "3o2b$" with a header giving the size and usually the rule, Generations states are written as letters
+//- macrocell (.mc), a quadtree of distinct squares, only the bounding box of living cells is loaded (MacrocellFile offers HashLife and windowed loading)
+//- plaintext (.cells), a row of cells per line with '.' for dead and 'O' for living cells and lines starting with '!' as comments,
+//  dying states of Generations rules are saved as dead cells and the rule is not saved at all
+class PatternFile
+{
+public:
+    //resizes the grid to the size of the pattern, rule is only changed if the file names one,
+    //returns false (after printing the reason) if the file cannot be read
+    static bool load(const std::string& filepath, CellGrid& cellGrid, LifeRule& rule);
+    static bool save(const std::string& filepath, const CellGrid& cellGrid, const LifeRule& rule);
+
+private:
+    static bool isRunLengthEncoded(const std::string& filepath);
+    static bool readWholeFile(const std::string& filepath, std::string& content);
+    static bool parsePlaintext(const std::string& content, CellGrid& cellGrid);
+    static bool parseRunLengthEncoded(const std::string& content, CellGrid& cellGrid, LifeRule& rule);
+    static std::string writePlaintext(const CellGrid& cellGrid);
+    static std::string writeRunLengthEncoded(const CellGrid& cellGrid, const LifeRule& rule);
+};
+
+#endif //GAMEOFLIFE_PATTERNFILE
@@ -0,0 +1,55 @@
+#ifndef GAMEOFLIFE_SIMDCELLENGINE
+#define GAMEOFLIFE_SIMDCELLENGINE
+
+#include <cstdint>
+#include <vector>
+
+#include "CellEngine.h"
+
+//vectorized CPU engine working on the same column-major byte cells as the OpenCL cell kernel, surrounded by a halo of cells filled according
+//to the topology so no bounds checks are needed, the widest instruction set supported by the processor (AVX-512 BW, AVX2 or SSE2) is chosen on startup,
+//every state of Generations rules fits into a byte, so they are simulated as well
+class SimdCellEngine : public CellEngine
+{
+public:
+    typedef void (*CalculateColumnsFunction)(const uint8_t* inputCellValues, uint8_t* outputCellValues, int columnCount, int rowCount, int columnStride, const LifeRule& rule);
+
+    enum class InstructionSet
+    {
+        scalar,
+        sse2,
+        avx2,
+        avx512
+    };
+
+private:
+    int mColumnCount, mRowCount;
+    int mColumnStride;//every column holds one halo cell above and below the board
+    BoardTopology mTopology;
+    LifeRule mRule;
+
+    std::vector<uint8_t> mInputCellValues;
+    std::vector<uint8_t> mOutputCellValues;
+
+    InstructionSet mInstructionSet;
+    std::string mInstructionSetName;
+    CalculateColumnsFunction mCalculateColumns;//instantiation for both the instruction set and the current rule
+
+public:
+    //scalar fallback can be forced to measure how much the vector instructions gain
+    explicit SimdCellEngine(bool isScalarForced = false);
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void getCells(CellGrid& cellGrid) override;
+    void setTopology(BoardTopology topology) override;
+    void setRule(const LifeRule& rule) override;
+    bool isRuleSupported(const LifeRule& rule) const override;
+
+    std::string getName() const override;
+
+private:
+    void fillHalo();
+};
+
+#endif //GAMEOFLIFE_SIMDCELLENGINE
@@ -0,0 +1,54 @@
+#ifndef GAMEOFLIFE_SIMULATION
+#define GAMEOFLIFE_SIMULATION
+
+#include <memory>
+#include <vector>
+
+#include "CellGrid.h"
+#include "CellEngine.h"
+
+//board together with every engine able to simulate its rule, keeps the host grid and the copy kept by the current engine in sync lazily,
+//so front ends (interactive canvas, batch jobs) only edit the grid and ask for generations without knowing which side is newer
+class Simulation
+{
+private:
+    CellGrid mCellGrid;
+
+    std::vector<std::unique_ptr<CellEngine>> mCellEngines;
+    int mCurrentCellEngineIndex;
+    BoardTopology mTopology;
+    LifeRule mRule;
+    //engines keep their own copy of the board, so cells are only exchanged with them when one side actually changed
+    bool mIsCellGridOutdated;
+    bool mIsCellEngineOutdated;
+
+public:
+    Simulation(int columnCount, int rowCount, const LifeRule& rule = LifeRule::conway());
+
+    //grid may lag behind the engine, call synchronizeCellGridWithEngine first to get the newest generation
+    const CellGrid& getCellGrid() const { return mCellGrid; }
+    const LifeRule& getRule() const { return mRule; }
+    BoardTopology getTopology() const { return mTopology; }
+    CellEngine& getCellEngine() { return *mCellEngines[mCurrentCellEngineIndex]; }
+
+    //both keep cells already on the board, so the newest generation is fetched from the engine first
+    void setCellValue(int column, int row, int cellValue);
+    void resize(int columnCount, int rowCount);
+    //replaces the board with the pattern placed in its middle, parts of the pattern not fitting on the board are cut
+    void placePattern(const CellGrid& pattern);
+
+    //new generations stay inside the engine (on the device for OpenCL) until the grid is synchronized
+    void calculateNextGenerations(int generationCount);
+    void finish();
+    //returns true if the grid changed, so anything showing it has to be updated
+    bool synchronizeCellGridWithEngine();
+
+    void switchCellEngine();
+    void switchTopology();
+
+private:
+    //the interactive version keeps such engines on offer, a warning is enough since cells are still shown
+    void reportUnsupportedTopology();
+};
+
+#endif //GAMEOFLIFE_SIMULATION
@@ -0,0 +1,36 @@
+#ifndef GAMEOFLIFE_SPARSECELLENGINE
+#define GAMEOFLIFE_SPARSECELLENGINE
+
+#include "BitPackedCellEngine.h"
+
+//bit-packed engine remembering which 64x64 tiles changed in the previous generation, only those tiles and their neighbours are recalculated,
+//so mostly dead or mostly still boards cost time proportional to their activity instead of their area
+class SparseCellEngine : public BitPackedCellEngine
+{
+private:
+    int mTileColumnCount, mTileRowCount;
+    std::vector<uint8_t> mChangedTiles;
+    std::vector<uint8_t> mNextChangedTiles;
+    int mSkippedTileCount;
+    uint64_t mTotalSkippedTileCount;
+
+public:
+    SparseCellEngine();
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+
+    std::string getName() const override;
+
+    int getTileCount() const;
+    //number of tiles which did not have to be recalculated during the last generation
+    int getSkippedTileCount() const;
+    //same for all generations since the last call to setCells
+    uint64_t getTotalSkippedTileCount() const;
+
+private:
+    bool isTileOrNeighbourChanged(int tileColumn, int tileRow) const;
+    bool isAnyEdgeTileChangedInPreviousGeneration() const;
+};
+
+#endif //GAMEOFLIFE_SPARSECELLENGINE
@@ -0,0 +1,37 @@
+#ifndef GAMEOFLIFE_STATETEXTURECELLRENDERER
+#define GAMEOFLIFE_STATETEXTURECELLRENDERER
+
+#include <vector>
+
+#include "CellRenderer.h"
+
+//writes cell states into a texture with one texel per cell and draws it as one scaled sprite, a fragment shader
+//(Resources/Shaders/cellState.frag) maps every state back to dead or alive cell image (tinted for dying states), so no per-cell objects exist at all
+class StateTextureCellRenderer : public CellRenderer
+{
+private:
+    const sf::Texture& mCellAtlasTexture;
+
+    int mColumnCount, mRowCount;
+    std::vector<sf::Uint8> mStatePixels;//RGBA, since that is the only format sf::Texture accepts, red channel holds the state itself
+    sf::Texture mStateTexture;
+    sf::Sprite mStateSprite;
+    sf::Shader mCellStateShader;
+    bool mIsStateTextureOutdated;
+
+public:
+    StateTextureCellRenderer(const sf::Texture& cellAtlasTexture, int stateCount);
+
+    //shaders are not supported by every graphics driver, and a texel per cell limits board size to the maximum texture size
+    static bool isAvailable(int columnCount, int rowCount);
+
+    void setCanvasGeometry(int columnCount, int rowCount, sf::Vector2f canvasOrigin, float cellSize) override;
+    void updateCells(const CellGrid& cellGrid) override;
+    void updateCell(const CellGrid& cellGrid, int column, int row) override;
+
+    void draw(sf::RenderWindow& window, const sf::Transform& transform) override;
+
+    std::string getName() const override;
+};
+
+#endif //GAMEOFLIFE_STATETEXTURECELLRENDERER
@@ -0,0 +1,56 @@
+#ifndef GAMEOFLIFE_SUMMEDAREACELLENGINE
+#define GAMEOFLIFE_SUMMEDAREACELLENGINE
+
+#include <cstdint>
+#include <vector>
+
+#include "CellEngine.h"
+#include "ThreadPool.h"
+
+//byte per cell engine counting neighbours with prefix sums of living cells instead of visiting them, so Larger than Life rules with large ranges
+//cost about the same per cell as Conway's rule (Moore neighbourhoods take 4 lookups into a summed-area table, von Neumann diamonds are counted once
+//per column and then moved down it by 8 lookups into sums along both diagonals), tables cover the board padded by range cells on every side
+//filled according to the topology
+class SummedAreaCellEngine : public CellEngine
+{
+private:
+    int mColumnCount, mRowCount;
+    int mRange;//of the rule the tables were sized for
+    BoardTopology mTopology;
+    LifeRule mRule;
+
+    std::vector<uint8_t> mInputCellValues;
+    std::vector<uint8_t> mOutputCellValues;
+    std::vector<int> mColumnSums;//living cells of every padded column above every padded row (and one past the last one)
+    std::vector<int> mAreaSums;//living cells of all padded columns to the left summed the same way, one more column of zeros in front
+    //living cells of every padded cell and all cells before it on its diagonal going down and right (or down and left for the anti-diagonal),
+    //one more row of zeros above and one more column of zeros on both sides, only von Neumann neighbourhoods need them
+    std::vector<int> mDiagonalSums;
+    std::vector<int> mAntiDiagonalSums;
+
+    ThreadPool mThreadPool;
+
+public:
+    explicit SummedAreaCellEngine(int threadCount = std::thread::hardware_concurrency());
+
+    void setCells(const CellGrid& cellGrid) override;
+    void calculateNextGenerations(int generationCount) override;
+    void getCells(CellGrid& cellGrid) override;
+    void setTopology(BoardTopology topology) override;
+    void setRule(const LifeRule& rule) override;
+
+    std::string getName() const override;
+
+private:
+    int getPaddedColumnCount() const { return mColumnCount+2*mRange; }
+    int getPaddedRowCount() const { return mRowCount+2*mRange; }
+    size_t getDiagonalSumIndex(int paddedColumn, int paddedRow) const { return (size_t)(paddedColumn+1)*(getPaddedRowCount()+1)+paddedRow+1; }
+    void resizeSums();
+    bool wrapCell(int& column, int& row) const;
+    void calculateColumnSums();
+    void calculateAreaSums();
+    void calculateDiagonalSums();
+    void calculateColumn(int column);
+};
+
+#endif //GAMEOFLIFE_SUMMEDAREACELLENGINE
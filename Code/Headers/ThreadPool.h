@@ -0,0 +1,51 @@
+#ifndef GAMEOFLIFE_THREADPOOL
+#define GAMEOFLIFE_THREADPOOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//persistent worker threads running batches of numbered tasks, every worker starts with an equal range of task numbers
+//and, once it runs out of them, steals half of the remaining range of another worker, ranges are only ever changed with atomic compare-and-swap
+class ThreadPool
+{
+private:
+    struct alignas(64) TaskRange
+    {
+        std::atomic<uint64_t> range;//first task number in the upper 32 bits, one past the last task number in the lower 32 bits
+    };
+
+    std::vector<std::thread> mThreads;
+    std::vector<TaskRange> mTaskRanges;
+
+    std::function<void(int)> mTask;
+    std::atomic<int> mRemainingTaskCount;
+
+    std::mutex mMutex;
+    std::condition_variable mBatchStartCondition;
+    std::condition_variable mBatchFinishCondition;
+    uint64_t mBatchNumber;
+    int mBusyWorkerCount;
+    bool mIsStopping;
+
+public:
+    explicit ThreadPool(int threadCount = std::thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    int getThreadCount() const;
+
+    //calls task(0) ... task(taskCount-1) spread across all threads (including the calling one) and returns once all of them finish
+    void runTasks(int taskCount, const std::function<void(int)>& task);
+
+private:
+    void workerLoop(int workerIndex);
+    void processTasks(int workerIndex);
+    bool stealTasks(int workerIndex);
+};
+
+#endif //GAMEOFLIFE_THREADPOOL
@@ -0,0 +1,22 @@
+#ifndef GAMEOFLIFE_THREADEDCELLENGINE
+#define GAMEOFLIFE_THREADEDCELLENGINE
+
+#include "BitPackedCellEngine.h"
+#include "ThreadPool.h"
+
+//bit-packed engine splitting the board into cache-sized tiles stepped across all cores, every tile reads only the input buffer
+//and writes only its own part of the output buffer, so no locks are taken while calculating a generation
+class ThreadedCellEngine : public BitPackedCellEngine
+{
+private:
+    ThreadPool mThreadPool;
+
+public:
+    explicit ThreadedCellEngine(int threadCount = std::thread::hardware_concurrency());
+
+    void calculateNextGenerations(int generationCount) override;
+
+    std::string getName() const override;
+};
+
+#endif //GAMEOFLIFE_THREADEDCELLENGINE
@@ -0,0 +1,36 @@
+#ifndef GAMEOFLIFE_VERTEXARRAYCELLRENDERER
+#define GAMEOFLIFE_VERTEXARRAYCELLRENDERER
+
+#include <vector>
+
+#include "CellRenderer.h"
+
+//draws every cell as a textured quad of a single vertex array, so the whole board takes one draw call,
+//texture coordinates and colour of a quad are only changed when state of its cell changes
+class VertexArrayCellRenderer : public CellRenderer
+{
+private:
+    const sf::Texture& mCellAtlasTexture;//dead cell image on the left and alive cell image on the right
+    float mCellTextureSize;
+    int mStateCount;//dying states of Generations rules are drawn as alive cells tinted darker and darker
+
+    int mColumnCount, mRowCount;
+    sf::VertexArray mCellVertices;
+    std::vector<uint8_t> mDrawnCellValues;//cell values currently shown by vertices
+
+public:
+    VertexArrayCellRenderer(const sf::Texture& cellAtlasTexture, int stateCount);
+
+    void setCanvasGeometry(int columnCount, int rowCount, sf::Vector2f canvasOrigin, float cellSize) override;
+    void updateCells(const CellGrid& cellGrid) override;
+    void updateCell(const CellGrid& cellGrid, int column, int row) override;
+
+    void draw(sf::RenderWindow& window, const sf::Transform& transform) override;
+
+    std::string getName() const override;
+
+private:
+    void updateCellQuad(int column, int row, int cellValue);
+};
+
+#endif //GAMEOFLIFE_VERTEXARRAYCELLRENDERER
@@ -0,0 +1,177 @@
+#include "../Headers/BitPackedCellEngine.h"
+
+namespace
+{
+    bool getBit(const uint64_t* row, int bit)
+    {
+        return (row[bit/64] >> (bit%64)) & 1;
+    }
+
+    void setBit(uint64_t* row, int bit, bool value)
+    {
+        row[bit/64] = (row[bit/64] & ~((uint64_t)1 << (bit%64))) | ((uint64_t)value << (bit%64));
+    }
+}
+
+BitPackedCellEngine::BitPackedCellEngine()
+:mColumnCount(0),
+mRowCount(0),
+mWordsPerRow(0),
+mTopology(BoardTopology::deadBorder)
+{
+    setRule(LifeRule::conway());
+}
+
+void BitPackedCellEngine::setCells(const CellGrid& cellGrid)
+{
+    mColumnCount = cellGrid.getColumnCount();
+    mRowCount = cellGrid.getRowCount();
+    mWordsPerRow = (mColumnCount+2+63)/64;
+    mInputWords.assign((size_t)mWordsPerRow*(mRowCount+2), 0);
+    mOutputWords.assign((size_t)mWordsPerRow*(mRowCount+2), 0);
+
+    mCellMasks.assign(mWordsPerRow, 0);
+    for (int i=1; i<=mColumnCount; i++)
+    {
+        mCellMasks[i/64] |= (uint64_t)1 << (i%64);
+    }
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            if (cellGrid.getCellValue(i, j) == 1)
+            {
+                mInputWords[(size_t)(j+1)*mWordsPerRow+(i+1)/64] |= (uint64_t)1 << ((i+1)%64);
+            }
+        }
+    }
+}
+
+void BitPackedCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        fillGhostCells();
+        calculateTile(0, mRowCount, 0, mWordsPerRow);
+        mInputWords.swap(mOutputWords);
+    }
+}
+
+void BitPackedCellEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            cellGrid.setCellValue(i, j, (int)((mInputWords[(size_t)(j+1)*mWordsPerRow+(i+1)/64] >> ((i+1)%64)) & 1));
+        }
+    }
+}
+
+void BitPackedCellEngine::setTopology(BoardTopology topology)
+{
+    mTopology = topology;
+}
+
+void BitPackedCellEngine::setRule(const LifeRule& rule)
+{
+    mRule = rule;
+    mCalculateTile = selectLifeRule(rule, [](auto selectedRule) -> CalculateTileFunction
+    {
+        return &BitPackedCellEngine::calculateTileWithRule<decltype(selectedRule)>;
+    });
+}
+
+bool BitPackedCellEngine::isRuleSupported(const LifeRule& rule) const
+{
+    //every cell is a single bit, so there is no room for dying states, and adders only sum the 8 cells around
+    return !rule.isGenerations() && !rule.hasExtendedNeighbourhood();
+}
+
+std::string BitPackedCellEngine::getName() const
+{
+    return "CPU bit-packed";
+}
+
+void BitPackedCellEngine::calculateTile(int firstRow, int lastRow, int firstWord, int lastWord)
+{
+    (this->*mCalculateTile)(firstRow, lastRow, firstWord, lastWord);
+}
+
+template<typename Rule>
+void BitPackedCellEngine::calculateTileWithRule(int firstRow, int lastRow, int firstWord, int lastWord)
+{
+    for (int j=firstRow; j<lastRow; j++)
+    {
+        //ghost rows make sure there always is a row above and below
+        const uint64_t* rowAbove = &mInputWords[(size_t)j*mWordsPerRow];
+        const uint64_t* row = &mInputWords[(size_t)(j+1)*mWordsPerRow];
+        const uint64_t* rowBelow = &mInputWords[(size_t)(j+2)*mWordsPerRow];
+        uint64_t* outputRow = &mOutputWords[(size_t)(j+1)*mWordsPerRow];
+
+        for (int w=firstWord; w<lastWord; w++)
+        {
+            uint64_t above = rowAbove[w];
+            uint64_t center = row[w];
+            uint64_t below = rowBelow[w];
+            uint64_t abovePrevious = (w > 0) ? rowAbove[w-1] : 0;
+            uint64_t centerPrevious = (w > 0) ? row[w-1] : 0;
+            uint64_t belowPrevious = (w > 0) ? rowBelow[w-1] : 0;
+            uint64_t aboveNext = (w < mWordsPerRow-1) ? rowAbove[w+1] : 0;
+            uint64_t centerNext = (w < mWordsPerRow-1) ? row[w+1] : 0;
+            uint64_t belowNext = (w < mWordsPerRow-1) ? rowBelow[w+1] : 0;
+
+            //neighbours on the left of every cell are the row shifted towards higher columns, and the other way round
+            uint64_t aboveWest = (above << 1) | (abovePrevious >> 63);
+            uint64_t aboveEast = (above >> 1) | (aboveNext << 63);
+            uint64_t centerWest = (center << 1) | (centerPrevious >> 63);
+            uint64_t centerEast = (center >> 1) | (centerNext << 63);
+            uint64_t belowWest = (below << 1) | (belowPrevious >> 63);
+            uint64_t belowEast = (below >> 1) | (belowNext << 63);
+
+            //ghost cells and bits past the last column have to stay dead, otherwise they would act as living neighbours
+            outputRow[w] = calculateNextWord<Rule>(aboveWest, above, aboveEast, centerWest, center, centerEast, belowWest, below, belowEast, mRule) & mCellMasks[w];
+        }
+    }
+}
+
+void BitPackedCellEngine::fillGhostCells()
+{
+    //ghost cells of a dead border are never written, so they stay dead in both buffers
+    if (mTopology == BoardTopology::deadBorder)
+    {
+        return;
+    }
+
+    //columns are filled first, so ghost rows copied afterwards already contain the corners
+    for (int j=1; j<=mRowCount; j++)
+    {
+        uint64_t* row = &mInputWords[(size_t)j*mWordsPerRow];
+        setBit(row, 0, getBit(row, mColumnCount));
+        setBit(row, mColumnCount+1, getBit(row, 1));
+    }
+
+    uint64_t* firstRow = &mInputWords[(size_t)1*mWordsPerRow];
+    uint64_t* lastRow = &mInputWords[(size_t)mRowCount*mWordsPerRow];
+    uint64_t* ghostRowAbove = &mInputWords[0];
+    uint64_t* ghostRowBelow = &mInputWords[(size_t)(mRowCount+1)*mWordsPerRow];
+    if (mTopology == BoardTopology::torus)
+    {
+        std::copy_n(lastRow, mWordsPerRow, ghostRowAbove);
+        std::copy_n(firstRow, mWordsPerRow, ghostRowBelow);
+        return;
+    }
+
+    //Klein bottle reverses the row crossing the top or bottom edge, together with its ghost cells
+    for (int i=0; i<=mColumnCount+1; i++)
+    {
+        setBit(ghostRowAbove, mColumnCount+1-i, getBit(lastRow, i));
+        setBit(ghostRowBelow, mColumnCount+1-i, getBit(firstRow, i));
+    }
+}
@@ -1,59 +1,35 @@
 #include "../Headers/CellCanvas.h"
 
-#define spriteCanvasToScreenProportion 0.85f
+#define cellCanvasToScreenProportion 0.85f
+//part of every frame which batched updates are allowed to spend on calculating generations, the rest is left for input and drawing
+#define batchedUpdateFrameTimeShare 0.5
 
-CellCanvas::CellCanvas(int screenWidth, int screenHeight, int columnCount, int rowCount)
+CellCanvas::CellCanvas(int screenWidth, int screenHeight, int columnCount, int rowCount, const LifeRule& rule)
 :mScreenWidth(screenWidth),
 mScreenHeight(screenHeight),
 mColumnCount(columnCount),
 mRowCount(rowCount),
 mTimeSinceLastUpdate(0),
 mUpdateInterval(1000000),
-mUpdateIntervalDivider(1)
+mUpdateIntervalDivider(1),
+mIsBatchedUpdateEnabled(false),
+mAverageGenerationTime(0),
+mSimulation(columnCount, rowCount, rule),
+mCellSize(0),
+mIsStateTextureRendererEnabled(false)
 {
-    mDeadCellTexture.loadFromFile("Resources/Images/deadCell.png");
-    mAliveCellTexture.loadFromFile("Resources/Images/aliveCell.png");
-
-    updateCellsAndSpritesToMatchColumnsAndRows();
-
-    //sets default platform and device to use for kernel calculations, allDevicesOnDefaultPlatform[0] is CPU, allDevicesOnDefaultPlatform[1] is GPU
-    std::vector<cl::Platform> allPlatforms = OpenCLFunctions::getAllPlatforms();
-    mOpenCLObject.platform = allPlatforms[0];
-    std::vector<cl::Device> allDevicesOnDefaultPlatform = OpenCLFunctions::getAllDevicesOnPlatform(mOpenCLObject.platform);
-    //GPU should generally be used whenever available, but not every PC has a separate GPU
-    if (allDevicesOnDefaultPlatform.size() < 2)
-    {
-        mOpenCLObject.device = allDevicesOnDefaultPlatform[0];
-    }
-    else
-    {
-        mOpenCLObject.device = allDevicesOnDefaultPlatform[1];
-    }
-
-    //sets OpenCL context and begins allocating memory on the device using OpenCL buffer objects
-    mOpenCLObject.context = cl::Context({mOpenCLObject.device});
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceColumnCount, 1*sizeof(int), mOpenCLObject.context);
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceRowCount, 1*sizeof(int), mOpenCLObject.context);
-    
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceInputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.context);
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceOutputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.context);
-
-    //sets remaining OpenCL objects including two kernels with two separate programs that will be used during fractal generation
-    mOpenCLObject.programCell = OpenCLFunctions::buildProgramFromFile(mOpenCLObject.device, mOpenCLObject.context, "Resources/Kernels/cell.txt");
-    mOpenCLObject.commandQueue = cl::CommandQueue(mOpenCLObject.context, mOpenCLObject.device);
-    mOpenCLObject.bufferOutputCellValues = new int[mColumnCount*mRowCount*3];
-    mOpenCLObject.kernelCell = OpenCLFunctions::createKernelForProgram("cell", mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceInputCellValues, mOpenCLObject.deviceOutputCellValues});
-
-    //local and global work sizes can only be decided after kernels are created
-    int bestLocalWorkgroupSizePerDimension = OpenCLFunctions::findBestLocalWorkgroupSizePerDimension(mOpenCLObject.kernelCell, mOpenCLObject.device);
-    mOpenCLObject.localWorkGroupSize = cl::NDRange(bestLocalWorkgroupSizePerDimension, bestLocalWorkgroupSizePerDimension);
-    mOpenCLObject.globalWorkGroupSize = OpenCLFunctions::findBestGlobalWorkgroupSize(bestLocalWorkgroupSizePerDimension, mColumnCount, mRowCount);
-
-    //finally send to the device all the data that is already known
-    int arrayFormColumnCount[1] = {mColumnCount};
-    int arrayFormRowCount[1] = {mRowCount};
-    OpenCLFunctions::sendDataToDevice((void*)arrayFormColumnCount, mOpenCLObject.deviceColumnCount, 1*sizeof(int), mOpenCLObject.commandQueue);
-    OpenCLFunctions::sendDataToDevice((void*)arrayFormRowCount, mOpenCLObject.deviceRowCount, 1*sizeof(int), mOpenCLObject.commandQueue);
+    sf::Image deadCellImage;
+    sf::Image aliveCellImage;
+    deadCellImage.loadFromFile("Resources/Images/deadCell.png");
+    aliveCellImage.loadFromFile("Resources/Images/aliveCell.png");
+    sf::Image cellAtlasImage;
+    cellAtlasImage.create(deadCellImage.getSize().x*2, deadCellImage.getSize().y);
+    cellAtlasImage.copy(deadCellImage, 0, 0);
+    cellAtlasImage.copy(aliveCellImage, deadCellImage.getSize().x, 0);
+    mCellAtlasTexture.loadFromImage(cellAtlasImage);
+
+    mCellRenderer = std::make_unique<VertexArrayCellRenderer>(mCellAtlasTexture, mSimulation.getRule().stateCount);
+    updateCellsAndRendererToMatchColumnsAndRows();
 }
 
 CellCanvas::~CellCanvas()
@@ -63,68 +39,74 @@ CellCanvas::~CellCanvas()
 
 TwoValueKey CellCanvas::getCellByPositionOnScreen(sf::Vector2<int> position)
 {
-    if (mMapOfSprites.find(TwoValueKey(0,0)) == mMapOfSprites.end())
+    sf::Vector2<int> cell = getUnboundedCellByPositionOnScreen(position);
+    if (!mSimulation.getCellGrid().containsCell(cell.x, cell.y))
     {
         return TwoValueKey(-1,-1);
     }
 
-    float spriteScale = mMapOfSprites.find(TwoValueKey(0,0))->second.getScale().x;
-    float spriteSize = spriteScale*100;
-    for (std::map<TwoValueKey, sf::Sprite>::iterator iter=mMapOfSprites.begin(); iter != mMapOfSprites.end(); iter++)
-    {
-        sf::Vector2 spritePosition = iter->second.getPosition();
-        if (position.x>=spritePosition.x-(spriteSize/2) && position.x<=spritePosition.x+(spriteSize/2))
-        {
-            if (position.y>=spritePosition.y-(spriteSize/2) && position.y<=spritePosition.y+(spriteSize/2))
-            {
-                return iter->first;
-            }
-        }
-    }
-
-    return TwoValueKey(-1,-1);
+    return TwoValueKey(cell.x, cell.y);
 }
 
-void CellCanvas::switchCellState(TwoValueKey cell)
+int CellCanvas::switchCellState(TwoValueKey cell)
 {
-    std::map<TwoValueKey, int>::iterator iterCell = mMapOfCells.find(cell);
-    if (iterCell == mMapOfCells.end())
+    if (!mSimulation.getCellGrid().containsCell(cell.x, cell.y))
     {
-        return;
+        return -1;
     }
 
-    if (iterCell->second == 1)
-    {
-        iterCell->second = 0;
-    }
-    else
-    {
-        iterCell->second = 1;
-    }
+    synchronizeCellGridWithEngine();
+    int cellValue = (mSimulation.getCellGrid().getCellValue(cell.x, cell.y) == 1) ? 0 : 1;
+    setCellState(cell.x, cell.y, cellValue);
+    return cellValue;
+}
 
-    std::map<TwoValueKey, sf::Sprite>::iterator iterSprite = mMapOfSprites.find(cell);
-    if (iterCell->second == 1)
-    {
-        iterSprite->second.setTexture(mAliveCellTexture);
-    }
-    else
+void CellCanvas::setCellStatesAlongLine(sf::Vector2<int> beginPosition, sf::Vector2<int> endPosition, int cellValue)
+{
+    synchronizeCellGridWithEngine();
+
+    //mouse can travel many cells between two events, so every cell on the line between them is painted (Bresenham's algorithm),
+    //cells outside the board are skipped, but still walked through, since the line may enter the board again
+    sf::Vector2<int> cell = getUnboundedCellByPositionOnScreen(beginPosition);
+    sf::Vector2<int> endCell = getUnboundedCellByPositionOnScreen(endPosition);
+    int distanceX = std::abs(endCell.x-cell.x);
+    int distanceY = -std::abs(endCell.y-cell.y);
+    int stepX = (cell.x < endCell.x) ? 1 : -1;
+    int stepY = (cell.y < endCell.y) ? 1 : -1;
+    int error = distanceX+distanceY;
+    while (true)
     {
-        iterSprite->second.setTexture(mDeadCellTexture);
+        if (mSimulation.getCellGrid().containsCell(cell.x, cell.y))
+        {
+            setCellState(cell.x, cell.y, cellValue);
+        }
+        if (cell == endCell)
+        {
+            break;
+        }
+        if (2*error >= distanceY)
+        {
+            error += distanceY;
+            cell.x += stepX;
+        }
+        if (2*error <= distanceX)
+        {
+            error += distanceX;
+            cell.y += stepY;
+        }
     }
 }
 
 void CellCanvas::addColumn()
 {
     mColumnCount += 1;
-    updateCellsAndSpritesToMatchColumnsAndRows();
-    updateOpenCLObjectToMatchColumnsAndRows();
+    updateCellsAndRendererToMatchColumnsAndRows();
 }
 
 void CellCanvas::addRow()
 {
     mRowCount += 1;
-    updateCellsAndSpritesToMatchColumnsAndRows();
-    updateOpenCLObjectToMatchColumnsAndRows();
+    updateCellsAndRendererToMatchColumnsAndRows();
 }
 
 void CellCanvas::removeColumn()
@@ -132,8 +114,7 @@ void CellCanvas::removeColumn()
     if (mColumnCount > 1)
     {
         mColumnCount -= 1;
-        updateCellsAndSpritesToMatchColumnsAndRows();
-        updateOpenCLObjectToMatchColumnsAndRows();
+        updateCellsAndRendererToMatchColumnsAndRows();
     }
 }
 
@@ -142,14 +123,21 @@ void CellCanvas::removeRow()
     if (mRowCount > 1)
     {
         mRowCount -= 1;
-        updateCellsAndSpritesToMatchColumnsAndRows();
-        updateOpenCLObjectToMatchColumnsAndRows();
+        updateCellsAndRendererToMatchColumnsAndRows();
     }
 }
 
 void CellCanvas::speedUpUpdateInterval()
 {
-    mUpdateIntervalDivider++;
+    //batched updates easily reach thousands of generations per second, so speed changes exponentially in that mode
+    if (mIsBatchedUpdateEnabled)
+    {
+        mUpdateIntervalDivider = std::min(mUpdateIntervalDivider*2, 1 << 24);
+    }
+    else
+    {
+        mUpdateIntervalDivider++;
+    }
 }
 
 void CellCanvas::slowDownUpdateInterval()
@@ -158,109 +146,191 @@ void CellCanvas::slowDownUpdateInterval()
     {
         return;
     }
-    mUpdateIntervalDivider--;
+    if (mIsBatchedUpdateEnabled)
+    {
+        mUpdateIntervalDivider /= 2;
+    }
+    else
+    {
+        mUpdateIntervalDivider--;
+    }
 }
 
-void CellCanvas::update(double deltaTime)
+void CellCanvas::switchCellEngine()
 {
-    mTimeSinceLastUpdate += deltaTime;
-    if (mTimeSinceLastUpdate >= (mUpdateInterval/mUpdateIntervalDivider))
+    synchronizeCellGridWithEngine();
+    mAverageGenerationTime = 0;
+    mSimulation.switchCellEngine();
+}
+
+void CellCanvas::switchBatchedUpdate()
+{
+    mIsBatchedUpdateEnabled = !mIsBatchedUpdateEnabled;
+    std::cout << "Batched updates " << (mIsBatchedUpdateEnabled ? "enabled" : "disabled") << std::endl;
+}
+
+void CellCanvas::switchCellRenderer()
+{
+    //state texture only pays off for very large boards, but either renderer draws any board that fits
+    if (!mIsStateTextureRendererEnabled)
     {
-        mTimeSinceLastUpdate -= (mUpdateInterval/mUpdateIntervalDivider);
-        updateCells();
-        updateSpritesToMatchCellStates();
+        if (!StateTextureCellRenderer::isAvailable(mColumnCount, mRowCount))
+        {
+            std::cout << "State texture rendering is not available for this board" << std::endl;
+            return;
+        }
+        mCellRenderer = std::make_unique<StateTextureCellRenderer>(mCellAtlasTexture, mSimulation.getRule().stateCount);
     }
+    else
+    {
+        mCellRenderer = std::make_unique<VertexArrayCellRenderer>(mCellAtlasTexture, mSimulation.getRule().stateCount);
+    }
+    mIsStateTextureRendererEnabled = !mIsStateTextureRendererEnabled;
+    std::cout << "Using cell renderer: " << mCellRenderer->getName() << std::endl;
+
+    synchronizeCellGridWithEngine();
+    mCellRenderer->setCanvasGeometry(mColumnCount, mRowCount, mCanvasOrigin, mCellSize);
+    mCellRenderer->updateCells(mSimulation.getCellGrid());
 }
 
-void CellCanvas::draw(sf::RenderWindow &window)
+void CellCanvas::switchTopology()
 {
-    for (std::map<TwoValueKey, sf::Sprite>::iterator iter=mMapOfSprites.begin(); iter != mMapOfSprites.end(); iter++)
+    synchronizeCellGridWithEngine();
+    mSimulation.switchTopology();
+}
+
+void CellCanvas::placePattern(const CellGrid& pattern)
+{
+    mColumnCount = std::max(mColumnCount, pattern.getColumnCount());
+    mRowCount = std::max(mRowCount, pattern.getRowCount());
+    updateCellsAndRendererToMatchColumnsAndRows();
+    mSimulation.placePattern(pattern);
+    mCellRenderer->updateCells(mSimulation.getCellGrid());
+}
+
+void CellCanvas::savePattern(const std::string& filepath)
+{
+    synchronizeCellGridWithEngine();
+    if (PatternFile::save(filepath, mSimulation.getCellGrid(), mSimulation.getRule()))
     {
-        window.draw(iter->second);
+        std::cout << "Board saved to " << filepath << std::endl;
     }
 }
 
-void CellCanvas::updateCells()
+void CellCanvas::zoomView(float factor, sf::Vector2<int> position)
+{
+    //point under the mouse cursor stays in place while everything else scales around it
+    sf::Transform zoomTransform;
+    zoomTransform.translate((float)position.x, (float)position.y).scale(factor, factor).translate(-(float)position.x, -(float)position.y);
+    mViewTransform = zoomTransform*mViewTransform;
+}
+
+void CellCanvas::panView(sf::Vector2<int> offset)
+{
+    sf::Transform panTransform;
+    panTransform.translate((float)offset.x, (float)offset.y);
+    mViewTransform = panTransform*mViewTransform;
+}
+
+void CellCanvas::resetView()
 {
-    //OpenCL only likes arrays, so convert map to array
-    int arrayFormInputCellValues[mColumnCount*mRowCount];
-    for (std::map<TwoValueKey, int>::iterator iterCell=mMapOfCells.begin(); iterCell != mMapOfCells.end(); iterCell++)
+    mViewTransform = sf::Transform::Identity;
+}
+
+void CellCanvas::update(double deltaTime, double frameTime)
+{
+    mTimeSinceLastUpdate += deltaTime;
+    double updateInterval = mUpdateInterval/mUpdateIntervalDivider;
+    if (mTimeSinceLastUpdate < updateInterval)
     {
-        arrayFormInputCellValues[iterCell->first.x*mRowCount+iterCell->first.y] = iterCell->second;
+        return;
     }
 
-    //sends all the necessary (changing between frames) data to kernels
-    OpenCLFunctions::sendDataToDevice((void*)arrayFormInputCellValues, mOpenCLObject.deviceInputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.commandQueue);
+    if (!mIsBatchedUpdateEnabled)
+    {
+        mTimeSinceLastUpdate -= updateInterval;
+        updateCells(1);
+        return;
+    }
 
-    //begins calculating new cell values for every cell
-    OpenCLFunctions::startKernel(mOpenCLObject.kernelCell, mOpenCLObject.commandQueue, mOpenCLObject.localWorkGroupSize, mOpenCLObject.globalWorkGroupSize);
+    //calculates every generation that is due, but never more than measured time per generation allows to fit in the frame
+    int dueGenerationCount = (int)std::min(mTimeSinceLastUpdate/updateInterval, 1000000000.0);
+    int maxGenerationCount = 1;
+    if (mAverageGenerationTime > 0)
+    {
+        maxGenerationCount = (int)std::clamp(frameTime*batchedUpdateFrameTimeShare/mAverageGenerationTime, 1.0, 1000000000.0);
+    }
+    int generationCount = std::min(dueGenerationCount, maxGenerationCount);
 
-    //waits for kernels to finish all their actions...
-    mOpenCLObject.commandQueue.finish();
+    //generations which could not fit are dropped instead of piling up and slowing down every following frame
+    mTimeSinceLastUpdate = std::min(mTimeSinceLastUpdate-generationCount*updateInterval, updateInterval);
 
-    //...before retrieving results...
-    OpenCLFunctions::getDataFromDevice((void*)mOpenCLObject.bufferOutputCellValues, mOpenCLObject.deviceOutputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.commandQueue);
+    std::chrono::steady_clock::time_point batchBegin = std::chrono::steady_clock::now();
+    updateCells(generationCount);
+    mSimulation.finish();
+    double batchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - batchBegin).count();
 
-    //...and using them to set cell values within canvas
-    for (int i=0; i<mColumnCount; i++)
+    double generationTime = std::max(batchTime/generationCount, 0.001);
+    if (mAverageGenerationTime == 0)
     {
-        for (int j=0; j<mRowCount; j++)
-        {
-            mMapOfCells.find(TwoValueKey(i,j))->second = mOpenCLObject.bufferOutputCellValues[i*mRowCount+j];
-        }
+        mAverageGenerationTime = generationTime;
+    }
+    else
+    {
+        mAverageGenerationTime = 0.8*mAverageGenerationTime+0.2*generationTime;
     }
 }
 
-void CellCanvas::updateSpritesToMatchCellStates()
+void CellCanvas::draw(sf::RenderWindow &window)
 {
-    for (std::map<TwoValueKey, int>::iterator iterCell=mMapOfCells.begin(); iterCell != mMapOfCells.end(); iterCell++)
-    {
-        std::map<TwoValueKey, sf::Sprite>::iterator iterSprite=mMapOfSprites.find(iterCell->first);
-        if (iterCell->second == 1)
-        {
-            iterSprite->second.setTexture(mAliveCellTexture);
-        }
-        else
-        {
-            iterSprite->second.setTexture(mDeadCellTexture);
-        }
-    }
+    synchronizeCellGridWithEngine();
+    mCellRenderer->draw(window, mViewTransform);
+}
+
+sf::Vector2<int> CellCanvas::getUnboundedCellByPositionOnScreen(sf::Vector2<int> position)
+{
+    //cells form a regular grid, so the cell under given position is calculated directly instead of searched for
+    sf::Vector2f canvasPosition = mViewTransform.getInverse().transformPoint((float)position.x, (float)position.y);
+    return sf::Vector2<int>((int)std::floor((canvasPosition.x-mCanvasOrigin.x)/mCellSize), (int)std::floor((canvasPosition.y-mCanvasOrigin.y)/mCellSize));
+}
+
+void CellCanvas::setCellState(int column, int row, int cellValue)
+{
+    mSimulation.setCellValue(column, row, cellValue);
+    mCellRenderer->updateCell(mSimulation.getCellGrid(), column, row);
+}
+
+void CellCanvas::updateCells(int generationCount)
+{
+    //new generations stay inside the engine (on the device for OpenCL) until they have to be drawn or edited
+    mSimulation.calculateNextGenerations(generationCount);
 }
 
-void CellCanvas::updateCellsAndSpritesToMatchColumnsAndRows()
+void CellCanvas::synchronizeCellGridWithEngine()
 {
-    float widthBasedSpriteScale = ((float)mScreenWidth/mColumnCount)/100*spriteCanvasToScreenProportion;
-    float heightBasedSpriteScale = ((float)mScreenHeight/mRowCount)/100*spriteCanvasToScreenProportion;
-    float spriteScale = std::min(widthBasedSpriteScale, heightBasedSpriteScale);
-    mMapOfCells.clear();
-    mMapOfSprites.clear();
-    for (int i=0; i<mColumnCount; i++)
+    if (mSimulation.synchronizeCellGridWithEngine())
     {
-        for (int j=0; j<mRowCount; j++)
-        {
-            mMapOfCells.insert(std::make_pair(TwoValueKey(i, j), 0));
-            sf::Sprite sprite;
-            sprite.setTexture(mDeadCellTexture);
-            sprite.setScale(spriteScale, spriteScale);
-            sprite.setOrigin(50, 50);
-            sprite.setPosition(mScreenWidth/2.0+spriteScale*100*(i-mColumnCount/2.0+0.5), mScreenHeight/2.0+spriteScale*100*(j-mRowCount/2.0+0.5));
-            mMapOfSprites.insert(std::make_pair(TwoValueKey(i, j), sprite));
-        }
+        mCellRenderer->updateCells(mSimulation.getCellGrid());
     }
 }
 
-void CellCanvas::updateOpenCLObjectToMatchColumnsAndRows()
+void CellCanvas::updateCellsAndRendererToMatchColumnsAndRows()
 {
-    mOpenCLObject.deviceInputCellValues = cl::Buffer();
-    mOpenCLObject.deviceOutputCellValues = cl::Buffer();
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceInputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.context);
-    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceOutputCellValues, mColumnCount*mRowCount*sizeof(int), mOpenCLObject.context);
-    mOpenCLObject.kernelCell = OpenCLFunctions::createKernelForProgram("cell", mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceInputCellValues, mOpenCLObject.deviceOutputCellValues});
-    int arrayFormColumnCount[1] = {mColumnCount};
-    int arrayFormRowCount[1] = {mRowCount};
-    OpenCLFunctions::sendDataToDevice((void*)arrayFormColumnCount, mOpenCLObject.deviceColumnCount, 1*sizeof(int), mOpenCLObject.commandQueue);
-    OpenCLFunctions::sendDataToDevice((void*)arrayFormRowCount, mOpenCLObject.deviceRowCount, 1*sizeof(int), mOpenCLObject.commandQueue);
-    int bestLocalWorkgroupSizePerDimension = OpenCLFunctions::findBestLocalWorkgroupSizePerDimension(mOpenCLObject.kernelCell, mOpenCLObject.device);
-    mOpenCLObject.localWorkGroupSize = cl::NDRange(bestLocalWorkgroupSizePerDimension, bestLocalWorkgroupSizePerDimension);
-    mOpenCLObject.globalWorkGroupSize = OpenCLFunctions::findBestGlobalWorkgroupSize(bestLocalWorkgroupSizePerDimension, mColumnCount, mRowCount);
+    float widthBasedCellSize = (float)mScreenWidth/mColumnCount*cellCanvasToScreenProportion;
+    float heightBasedCellSize = (float)mScreenHeight/mRowCount*cellCanvasToScreenProportion;
+    mCellSize = std::min(widthBasedCellSize, heightBasedCellSize);
+    mCanvasOrigin = sf::Vector2f(mScreenWidth/2.0-mCellSize*mColumnCount/2.0, mScreenHeight/2.0-mCellSize*mRowCount/2.0);
+
+    //pattern survives resizing, so the newest generation has to be fetched from the engine before the board changes
+    synchronizeCellGridWithEngine();
+    mSimulation.resize(mColumnCount, mRowCount);
+
+    //board may have outgrown the maximum texture size
+    if (mIsStateTextureRendererEnabled && !StateTextureCellRenderer::isAvailable(mColumnCount, mRowCount))
+    {
+        mCellRenderer = std::make_unique<VertexArrayCellRenderer>(mCellAtlasTexture, mSimulation.getRule().stateCount);
+        mIsStateTextureRendererEnabled = false;
+    }
+    mCellRenderer->setCanvasGeometry(mColumnCount, mRowCount, mCanvasOrigin, mCellSize);
+    mCellRenderer->updateCells(mSimulation.getCellGrid());
 }
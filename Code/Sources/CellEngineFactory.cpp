@@ -0,0 +1,104 @@
+#include "../Headers/CellEngineFactory.h"
+
+#include <iostream>
+
+#include "../Headers/OpenCLCellEngine.h"
+#include "../Headers/BitPackedCellEngine.h"
+#include "../Headers/SimdCellEngine.h"
+#include "../Headers/SummedAreaCellEngine.h"
+#include "../Headers/ThreadedCellEngine.h"
+#include "../Headers/SparseCellEngine.h"
+#include "../Headers/HashLifeEngine.h"
+#include "../Headers/ChunkedCellEngine.h"
+
+std::vector<std::string> CellEngineFactory::getEngineIds()
+{
+    //every engine calculates exactly the same generations, they only differ in how fast they do it on given hardware,
+    //machines without a usable OpenCL platform simply start with the fastest CPU engine instead
+    std::vector<std::string> engineIds;
+    if (OpenCLFunctions::isOpenCLAvailable())
+    {
+        engineIds.insert(engineIds.end(), {"opencl", "opencl-local", "opencl-packed"});
+    }
+    //scalar engine is the SIMD engine restricted to plain instructions, mostly useful as a baseline when measuring the others,
+    //summed-area engine counts neighbours from sums of living cells, so it is the CPU engine simulating Larger than Life rules,
+    //HashLife treats the board as a window onto an unbounded universe, so cells leaving the board are lost instead of dying at its border,
+    //chunked engine is unbounded as well, but its cost follows the living area instead of how repetitive the pattern is
+    engineIds.insert(engineIds.end(), {"threaded", "simd", "scalar", "summed-area", "bit-packed", "sparse", "hashlife", "chunked"});
+    return engineIds;
+}
+
+std::unique_ptr<CellEngine> CellEngineFactory::createEngine(const std::string& engineId)
+{
+    if (engineId == "opencl")
+    {
+        return std::make_unique<OpenCLCellEngine>(OpenCLKernelVariant::globalMemory);
+    }
+    if (engineId == "opencl-local")
+    {
+        return std::make_unique<OpenCLCellEngine>(OpenCLKernelVariant::localMemory);
+    }
+    if (engineId == "opencl-packed")
+    {
+        return std::make_unique<OpenCLCellEngine>(OpenCLKernelVariant::bitPacked);
+    }
+    if (engineId == "threaded")
+    {
+        return std::make_unique<ThreadedCellEngine>();
+    }
+    if (engineId == "simd")
+    {
+        return std::make_unique<SimdCellEngine>();
+    }
+    if (engineId == "scalar")
+    {
+        return std::make_unique<SimdCellEngine>(true);
+    }
+    if (engineId == "summed-area")
+    {
+        return std::make_unique<SummedAreaCellEngine>();
+    }
+    if (engineId == "bit-packed")
+    {
+        return std::make_unique<BitPackedCellEngine>();
+    }
+    if (engineId == "sparse")
+    {
+        return std::make_unique<SparseCellEngine>();
+    }
+    if (engineId == "hashlife")
+    {
+        return std::make_unique<HashLifeEngine>();
+    }
+    if (engineId == "chunked")
+    {
+        return std::make_unique<ChunkedCellEngine>();
+    }
+    return nullptr;
+}
+
+std::vector<std::unique_ptr<CellEngine>> CellEngineFactory::createEnginesForRule(const LifeRule& rule, BoardTopology topology)
+{
+    std::vector<std::string> engineIds = getEngineIds();
+    if (engineIds.front() != "opencl")
+    {
+        std::cout << "No usable OpenCL platform found, falling back to CPU cell engines" << std::endl;
+    }
+
+    //engines storing a single bit per cell are left out for Generations rules and most engines for Larger than Life rules,
+    //OpenCL global memory kernels and the summed-area engine handle every rule
+    std::vector<std::unique_ptr<CellEngine>> cellEngines;
+    for (const std::string& engineId : engineIds)
+    {
+        std::unique_ptr<CellEngine> cellEngine = createEngine(engineId);
+        if (!cellEngine->isRuleSupported(rule))
+        {
+            std::cout << "Cell engine " << cellEngine->getName() << " does not support rule " << rule.toString() << std::endl;
+            continue;
+        }
+        cellEngine->setTopology(topology);
+        cellEngine->setRule(rule);
+        cellEngines.push_back(std::move(cellEngine));
+    }
+    return cellEngines;
+}
@@ -0,0 +1,62 @@
+#include "../Headers/CellGrid.h"
+
+CellGrid::CellGrid(int columnCount, int rowCount)
+:mColumnCount(0),
+mRowCount(0),
+mColumnStride(0),
+mColumnCapacity(0)
+{
+    resize(columnCount, rowCount);
+}
+
+size_t CellGrid::getDataSize() const
+{
+    return (size_t)mColumnCount*mColumnStride*sizeof(uint8_t);
+}
+
+void CellGrid::resize(int columnCount, int rowCount)
+{
+    if (columnCount <= mColumnCapacity && rowCount <= mColumnStride)
+    {
+        //cells leaving the board are cleared, so they come back dead once the board grows again
+        clearCells(columnCount, mColumnCount, 0, mRowCount);
+        clearCells(0, std::min(columnCount, mColumnCount), rowCount, mRowCount);
+        mColumnCount = columnCount;
+        mRowCount = rowCount;
+        return;
+    }
+
+    //capacity at least doubles in every direction which ran out of it, so growing the board one column or row at a time
+    //only copies every cell a constant number of times on average
+    int newColumnCapacity = (columnCount > mColumnCapacity) ? std::max(columnCount, mColumnCapacity*2) : mColumnCapacity;
+    int newColumnStride = (rowCount > mColumnStride) ? std::max(rowCount, mColumnStride*2) : mColumnStride;
+    std::vector<uint8_t> newCellValues((size_t)newColumnCapacity*newColumnStride, 0);
+    int keptColumnCount = std::min(columnCount, mColumnCount);
+    int keptRowCount = std::min(rowCount, mRowCount);
+    for (int i=0; i<keptColumnCount; i++)
+    {
+        std::copy_n(&mCellValues[(size_t)i*mColumnStride], keptRowCount, &newCellValues[(size_t)i*newColumnStride]);
+    }
+
+    mCellValues.swap(newCellValues);
+    mColumnCount = columnCount;
+    mRowCount = rowCount;
+    mColumnStride = newColumnStride;
+    mColumnCapacity = newColumnCapacity;
+}
+
+void CellGrid::clear()
+{
+    std::fill(mCellValues.begin(), mCellValues.end(), 0);
+}
+
+void CellGrid::clearCells(int firstColumn, int lastColumn, int firstRow, int lastRow)
+{
+    for (int i=firstColumn; i<lastColumn; i++)
+    {
+        for (int j=firstRow; j<lastRow; j++)
+        {
+            mCellValues[(size_t)i*mColumnStride+j] = 0;
+        }
+    }
+}
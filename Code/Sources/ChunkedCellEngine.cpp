@@ -0,0 +1,237 @@
+#include "../Headers/ChunkedCellEngine.h"
+#include "../Headers/BitPackedCellEngine.h"
+
+namespace
+{
+    //chunk coordinates are 32-bit, so cells can move about 2^37 cells away from the origin before coordinates wrap around
+    uint64_t getChunkKey(int chunkColumn, int chunkRow)
+    {
+        return ((uint64_t)(uint32_t)chunkColumn << 32) | (uint32_t)chunkRow;
+    }
+
+    int getChunkColumn(uint64_t chunkKey)
+    {
+        return (int)(uint32_t)(chunkKey >> 32);
+    }
+
+    int getChunkRow(uint64_t chunkKey)
+    {
+        return (int)(uint32_t)chunkKey;
+    }
+
+    bool isChunkEmpty(const ChunkedCellEngine::Chunk& chunk)
+    {
+        for (uint64_t row : chunk)
+        {
+            if (row != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+ChunkedCellEngine::ChunkedCellEngine()
+:mColumnCount(0),
+mRowCount(0)
+{
+    setRule(LifeRule::conway());
+}
+
+void ChunkedCellEngine::setCells(const CellGrid& cellGrid)
+{
+    mColumnCount = cellGrid.getColumnCount();
+    mRowCount = cellGrid.getRowCount();
+    mChunks.clear();
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            if (cellGrid.getCellValue(i, j) == 1)
+            {
+                //value initialized chunks are completely dead
+                Chunk& chunk = mChunks[getChunkKey(i/chunkSize, j/chunkSize)];
+                chunk[j%chunkSize] |= (uint64_t)1 << (i%chunkSize);
+            }
+        }
+    }
+}
+
+void ChunkedCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        calculateNextGeneration();
+    }
+}
+
+void ChunkedCellEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+
+    //window only ever covers a few chunks, so they are looked up one by one instead of going through the whole map
+    for (int chunkColumn=0; chunkColumn*chunkSize<mColumnCount; chunkColumn++)
+    {
+        for (int chunkRow=0; chunkRow*chunkSize<mRowCount; chunkRow++)
+        {
+            const Chunk* chunk = findChunk(chunkColumn, chunkRow);
+            int lastColumn = std::min(chunkSize, mColumnCount-chunkColumn*chunkSize);
+            int lastRow = std::min(chunkSize, mRowCount-chunkRow*chunkSize);
+            for (int i=0; i<lastColumn; i++)
+            {
+                for (int j=0; j<lastRow; j++)
+                {
+                    int cellValue = chunk ? (int)(((*chunk)[j] >> i) & 1) : 0;
+                    cellGrid.setCellValue(chunkColumn*chunkSize+i, chunkRow*chunkSize+j, cellValue);
+                }
+            }
+        }
+    }
+}
+
+void ChunkedCellEngine::setRule(const LifeRule& rule)
+{
+    mRule = rule;
+    mCalculateChunk = selectLifeRule(rule, [](auto selectedRule) -> CalculateChunkFunction
+    {
+        return &ChunkedCellEngine::calculateChunk<decltype(selectedRule)>;
+    });
+}
+
+bool ChunkedCellEngine::isRuleSupported(const LifeRule& rule) const
+{
+    //chunks are bit-packed, so there is no room for dying states, and neighbours are only taken from adjacent chunks,
+    //B0 would fill the infinite empty plane around the chunks with living cells
+    return !rule.isGenerations() && !rule.hasExtendedNeighbourhood() && !rule.isBirth(0);
+}
+
+bool ChunkedCellEngine::isTopologySupported(BoardTopology topology) const
+{
+    //cells leaving the board live on in chunks around it, so edges cannot be joined
+    return topology == BoardTopology::deadBorder;
+}
+
+std::string ChunkedCellEngine::getName() const
+{
+    return "CPU chunked (unbounded)";
+}
+
+size_t ChunkedCellEngine::getChunkCount() const
+{
+    return mChunks.size();
+}
+
+void ChunkedCellEngine::calculateNextGeneration()
+{
+    growChunksAroundLivingEdges();
+
+    //chunks which died out are simply not carried over to the next generation
+    Chunk nextChunk;
+    for (const auto& chunk : mChunks)
+    {
+        (this->*mCalculateChunk)(chunk.first, nextChunk);
+        if (!isChunkEmpty(nextChunk))
+        {
+            mNextChunks.emplace(chunk.first, nextChunk);
+        }
+    }
+
+    mChunks.swap(mNextChunks);
+    mNextChunks.clear();
+}
+
+void ChunkedCellEngine::growChunksAroundLivingEdges()
+{
+    //cells can only be born next to living ones, so a missing chunk is needed only where living cells touch the edge facing it
+    mGrownChunkKeys.clear();
+    for (const auto& chunk : mChunks)
+    {
+        const Chunk& rows = chunk.second;
+        uint64_t livingColumns = 0;
+        for (uint64_t row : rows)
+        {
+            livingColumns |= row;
+        }
+        bool isWestEdgeAlive = (livingColumns & 1) != 0;
+        bool isEastEdgeAlive = (livingColumns >> (chunkSize-1)) != 0;
+        bool isNorthEdgeAlive = rows[0] != 0;
+        bool isSouthEdgeAlive = rows[chunkSize-1] != 0;
+
+        int chunkColumn = getChunkColumn(chunk.first);
+        int chunkRow = getChunkRow(chunk.first);
+        bool isNeighbourNeeded[3][3] =
+        {
+            {(rows[0] & 1) != 0, isWestEdgeAlive, (rows[chunkSize-1] & 1) != 0},
+            {isNorthEdgeAlive, false, isSouthEdgeAlive},
+            {(rows[0] >> (chunkSize-1)) != 0, isEastEdgeAlive, (rows[chunkSize-1] >> (chunkSize-1)) != 0}
+        };
+        for (int i=0; i<3; i++)
+        {
+            for (int j=0; j<3; j++)
+            {
+                uint64_t neighbourKey = getChunkKey(chunkColumn+i-1, chunkRow+j-1);
+                if (isNeighbourNeeded[i][j] && mChunks.find(neighbourKey) == mChunks.end())
+                {
+                    mGrownChunkKeys.push_back(neighbourKey);
+                }
+            }
+        }
+    }
+
+    //map can only be changed after going through it
+    for (uint64_t chunkKey : mGrownChunkKeys)
+    {
+        mChunks.try_emplace(chunkKey);
+    }
+}
+
+template<typename Rule>
+void ChunkedCellEngine::calculateChunk(uint64_t chunkKey, Chunk& nextChunk) const
+{
+    int chunkColumn = getChunkColumn(chunkKey);
+    int chunkRow = getChunkRow(chunkKey);
+    const Chunk* neighbours[3][3];
+    for (int i=0; i<3; i++)
+    {
+        for (int j=0; j<3; j++)
+        {
+            neighbours[i][j] = findChunk(chunkColumn+i-1, chunkRow+j-1);
+        }
+    }
+
+    //returns given row of the chunk in the given column of neighbours, rows -1 and chunkSize come from chunks above and below
+    auto getRow = [&neighbours](int neighbourColumn, int row) -> uint64_t
+    {
+        int neighbourRow = (row < 0) ? 0 : ((row < chunkSize) ? 1 : 2);
+        const Chunk* chunk = neighbours[neighbourColumn][neighbourRow];
+        return chunk ? (*chunk)[(row+chunkSize)%chunkSize] : 0;
+    };
+
+    for (int j=0; j<chunkSize; j++)
+    {
+        uint64_t above = getRow(1, j-1);
+        uint64_t center = getRow(1, j);
+        uint64_t below = getRow(1, j+1);
+
+        //neighbours on the left of every cell are the row shifted towards higher columns, the lowest bit comes from the last column of the chunk on the left
+        uint64_t aboveWest = (above << 1) | (getRow(0, j-1) >> (chunkSize-1));
+        uint64_t aboveEast = (above >> 1) | (getRow(2, j-1) << (chunkSize-1));
+        uint64_t centerWest = (center << 1) | (getRow(0, j) >> (chunkSize-1));
+        uint64_t centerEast = (center >> 1) | (getRow(2, j) << (chunkSize-1));
+        uint64_t belowWest = (below << 1) | (getRow(0, j+1) >> (chunkSize-1));
+        uint64_t belowEast = (below >> 1) | (getRow(2, j+1) << (chunkSize-1));
+
+        nextChunk[j] = BitPackedCellEngine::calculateNextWord<Rule>(aboveWest, above, aboveEast, centerWest, center, centerEast, belowWest, below, belowEast, mRule);
+    }
+}
+
+const ChunkedCellEngine::Chunk* ChunkedCellEngine::findChunk(int chunkColumn, int chunkRow) const
+{
+    auto chunk = mChunks.find(getChunkKey(chunkColumn, chunkRow));
+    return (chunk != mChunks.end()) ? &chunk->second : nullptr;
+}
@@ -1,16 +1,27 @@
 #include "../Headers/Game.h"
 
-Game::Game()
-:mWindow(sf::RenderWindow( sf::VideoMode( GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN), 32 ), "Game Of Life", sf::Style::Fullscreen )),
+//S saves the board here, in the run length encoded format together with the rule
+#define savedPatternFilepath "pattern.rle"
+
+Game::Game(const LifeRule& rule, const CellGrid* pattern)
+:mWindow(sf::RenderWindow( sf::VideoMode( sf::VideoMode::getDesktopMode().width, sf::VideoMode::getDesktopMode().height, 32 ), "Game Of Life", sf::Style::Fullscreen )),
 mDeltaTime(0),
 mRenderingFrameTimer(0),
 mExpectedRenderingFps(30),
-mCellCanvas(GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN), 30, 20),
-mIsPaused(false)
+mCellCanvas((int)sf::VideoMode::getDesktopMode().width, (int)sf::VideoMode::getDesktopMode().height, 30, 20, rule),
+mIsPaused(false),
+mIsPainting(false),
+mPaintedCellValue(0),
+mIsPanning(false)
 {
     mBackgroundTexture.setRepeated(true);
     mBackgroundTexture.loadFromFile("Resources/Images/background.png");
     mBackgroundSprite.setTexture(mBackgroundTexture);
+
+    if (pattern != nullptr)
+    {
+        mCellCanvas.placePattern(*pattern);
+    }
 }
 
 void Game::gameLoop()//main loop, it will continuously poll events, read them and terminate only if the window closes
@@ -64,6 +75,27 @@ void Game::processInput()
             mCellCanvas.slowDownUpdateInterval();
         }
 
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::E)
+        {
+            mCellCanvas.switchCellEngine();
+        }
+        else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B)
+        {
+            mCellCanvas.switchBatchedUpdate();
+        }
+        else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::R)
+        {
+            mCellCanvas.switchCellRenderer();
+        }
+        else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::T)
+        {
+            mCellCanvas.switchTopology();
+        }
+        else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::S)
+        {
+            mCellCanvas.savePattern(savedPatternFilepath);
+        }
+
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Right)
         {
             mCellCanvas.addColumn();
@@ -95,14 +127,53 @@ void Game::processInput()
 
         if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Button::Left)
         {
-            mCellCanvas.switchCellState(mCellCanvas.getCellByPositionOnScreen(sf::Mouse::getPosition(mWindow)));
+            mLastPaintingPosition = sf::Vector2<int>(event.mouseButton.x, event.mouseButton.y);
+            mPaintedCellValue = mCellCanvas.switchCellState(mCellCanvas.getCellByPositionOnScreen(mLastPaintingPosition));
+            mIsPainting = mPaintedCellValue != -1;
+        }
+        else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Button::Right)
+        {
+            mLastPanningPosition = sf::Vector2<int>(event.mouseButton.x, event.mouseButton.y);
+            mIsPanning = true;
+        }
+        else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Button::Left)
+        {
+            mIsPainting = false;
+        }
+        else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Button::Right)
+        {
+            mIsPanning = false;
+        }
+        else if (event.type == sf::Event::MouseMoved)
+        {
+            sf::Vector2<int> mousePosition(event.mouseMove.x, event.mouseMove.y);
+            if (mIsPainting)
+            {
+                mCellCanvas.setCellStatesAlongLine(mLastPaintingPosition, mousePosition, mPaintedCellValue);
+                mLastPaintingPosition = mousePosition;
+            }
+            if (mIsPanning)
+            {
+                mCellCanvas.panView(mousePosition-mLastPanningPosition);
+                mLastPanningPosition = mousePosition;
+            }
+        }
+        else if (event.type == sf::Event::MouseWheelScrolled)
+        {
+            mCellCanvas.zoomView(event.mouseWheelScroll.delta > 0 ? 1.25f : 0.8f, sf::Vector2<int>(event.mouseWheelScroll.x, event.mouseWheelScroll.y));
+        }
+
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Home)
+        {
+            mCellCanvas.resetView();
         }
     }
 }
 
 void Game::update()
 {
-    mCellCanvas.update(mDeltaTime);
+    //batched updates may fill part of the time left until the next frame has to be drawn
+    mCellCanvas.update(mDeltaTime, 1000000.0/mExpectedRenderingFps);
 }
 
 void Game::draw()
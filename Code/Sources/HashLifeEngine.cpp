@@ -0,0 +1,557 @@
+#include "../Headers/HashLifeEngine.h"
+
+#include <iostream>
+
+#define initialBucketCount (1 << 16)
+#define initialGarbageCollectionThreshold (1 << 22)
+#define maxStepExponent 56
+
+namespace
+{
+    uint64_t hashChildren(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+    {
+        uint64_t hash = nw;
+        hash = hash*0x9E3779B97F4A7C15ull+ne;
+        hash = hash*0x9E3779B97F4A7C15ull+sw;
+        hash = hash*0x9E3779B97F4A7C15ull+se;
+        return hash ^ (hash >> 29);
+    }
+}
+
+HashLifeEngine::HashLifeEngine()
+:mRoot(noNode),
+mStepExponent(0),
+mGenerationCount(0),
+mGarbageCollectionThreshold(initialGarbageCollectionThreshold),
+mColumnCount(0),
+mRowCount(0),
+mRule(LifeRule::conway())
+{
+    clear();
+}
+
+void HashLifeEngine::setCells(const CellGrid& cellGrid)
+{
+    clear();
+    mColumnCount = cellGrid.getColumnCount();
+    mRowCount = cellGrid.getRowCount();
+
+    int level = 3;
+    while (((int64_t)1 << (level-1)) < std::max(mColumnCount, mRowCount))
+    {
+        level++;
+    }
+    mRoot = buildNodeFromGrid(cellGrid, level, -((int64_t)1 << (level-1)), -((int64_t)1 << (level-1)));
+}
+
+void HashLifeEngine::calculateNextGenerations(int generationCount)
+{
+    if (generationCount > 0)
+    {
+        advanceByGenerations((uint64_t)generationCount);
+    }
+}
+
+void HashLifeEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+    cellGrid.clear();
+
+    int64_t halfSize = (int64_t)1 << (mNodes[mRoot].level-1);
+    writeNodeToGrid(cellGrid, mRoot, -halfSize, -halfSize);
+}
+
+void HashLifeEngine::setRule(const LifeRule& rule)
+{
+    //squares stay valid, only their futures were calculated with the old rule
+    if (!(rule == mRule))
+    {
+        mRule = rule;
+        clearResults();
+    }
+}
+
+bool HashLifeEngine::isRuleSupported(const LifeRule& rule) const
+{
+    //leaves are only ever dead or alive, and results of 4x4 squares only depend on the 8 cells around,
+    //B0 would turn the empty universe around the pattern alive, which empty squares cannot express
+    return !rule.isGenerations() && !rule.hasExtendedNeighbourhood() && !rule.isBirth(0);
+}
+
+bool HashLifeEngine::isTopologySupported(BoardTopology topology) const
+{
+    //board is only a window onto the universe, so there are no edges to join
+    return topology == BoardTopology::deadBorder;
+}
+
+std::string HashLifeEngine::getName() const
+{
+    return "CPU HashLife";
+}
+
+void HashLifeEngine::advanceByPowerOfTwo(int exponent)
+{
+    if (exponent < 0 || exponent > maxStepExponent)
+    {
+        std::cout << "HashLife step of 2^" << exponent << " generations is not supported" << std::endl;
+        return;
+    }
+
+    //garbage collection moves nodes around, so it can only be done between steps, when nothing but the root is referenced
+    if (mNodes.size() > mGarbageCollectionThreshold)
+    {
+        collectGarbage();
+        if (mNodes.size() > mGarbageCollectionThreshold/2)
+        {
+            mGarbageCollectionThreshold *= 2;
+        }
+    }
+
+    setStepExponent(exponent);
+
+    //result of a node only covers its center half, so universe has to be large enough for the pattern not to grow out of it
+    while (mNodes[mRoot].level < exponent+3 || !isPopulationInCenterQuarter(mRoot))
+    {
+        mRoot = expandUniverse(mRoot);
+    }
+
+    mRoot = calculateResult(mRoot);
+    mGenerationCount += (uint64_t)1 << exponent;
+}
+
+void HashLifeEngine::advanceByGenerations(uint64_t generationCount)
+{
+    if (generationCount >> (maxStepExponent+1) != 0)
+    {
+        std::cout << "HashLife run of " << generationCount << " generations is not supported" << std::endl;
+        return;
+    }
+
+    //any number of generations is a sum of powers of two, results of every step size are kept,
+    //so repeating the same run (as the interactive version does every frame) reuses all of them
+    for (int i=maxStepExponent; i>=0; i--)
+    {
+        if ((generationCount >> i) & 1)
+        {
+            advanceByPowerOfTwo(i);
+        }
+    }
+}
+
+uint64_t HashLifeEngine::getGenerationCount() const
+{
+    return mGenerationCount;
+}
+
+uint64_t HashLifeEngine::getPopulation() const
+{
+    return mNodes[mRoot].population;
+}
+
+size_t HashLifeEngine::getNodeCount() const
+{
+    return mNodes.size();
+}
+
+uint32_t HashLifeEngine::createNode(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se)
+{
+    uint32_t bucket = (uint32_t)(hashChildren(nw, ne, sw, se) & (mBuckets.size()-1));
+    for (uint32_t node=mBuckets[bucket]; node != noNode; node=mNodes[node].nextInBucket)
+    {
+        const Node& existingNode = mNodes[node];
+        if (existingNode.nw == nw && existingNode.ne == ne && existingNode.sw == sw && existingNode.se == se)
+        {
+            return node;
+        }
+    }
+
+    Node newNode;
+    newNode.nw = nw;
+    newNode.ne = ne;
+    newNode.sw = sw;
+    newNode.se = se;
+    newNode.result = noNode;
+    newNode.nextInBucket = mBuckets[bucket];
+    newNode.population = mNodes[nw].population+mNodes[ne].population+mNodes[sw].population+mNodes[se].population;
+    newNode.level = mNodes[nw].level+1;
+    mNodes.push_back(newNode);
+    mBuckets[bucket] = (uint32_t)(mNodes.size()-1);
+
+    if (mNodes.size() > mBuckets.size())
+    {
+        rehash(mBuckets.size()*2);
+    }
+
+    return (uint32_t)(mNodes.size()-1);
+}
+
+uint32_t HashLifeEngine::createEmptyNode(int level)
+{
+    if (level == 0)
+    {
+        return deadLeaf;
+    }
+
+    while (mEmptyNodes.size() <= (size_t)level)
+    {
+        mEmptyNodes.push_back(noNode);
+    }
+    if (mEmptyNodes[level] == noNode)
+    {
+        uint32_t child = createEmptyNode(level-1);
+        mEmptyNodes[level] = createNode(child, child, child, child);
+    }
+    return mEmptyNodes[level];
+}
+
+const HashLifeEngine::Node& HashLifeEngine::getNode(uint32_t node) const
+{
+    return mNodes[node];
+}
+
+uint32_t HashLifeEngine::getRoot() const
+{
+    return mRoot;
+}
+
+void HashLifeEngine::setRoot(uint32_t root)
+{
+    //roots smaller than the minimal universe are centered in an empty one
+    while (mNodes[root].level < 3)
+    {
+        if (mNodes[root].level == 0)
+        {
+            root = createNode(root, deadLeaf, deadLeaf, deadLeaf);
+        }
+        else
+        {
+            root = expandUniverse(root);
+        }
+    }
+    mRoot = root;
+}
+
+void HashLifeEngine::setGenerationCount(uint64_t generationCount)
+{
+    mGenerationCount = generationCount;
+}
+
+void HashLifeEngine::clear()
+{
+    mNodes.clear();
+    mEmptyNodes.clear();
+    mPartialResults.clear();
+    mBuckets.assign(initialBucketCount, noNode);
+    mStepExponent = 0;
+    mGenerationCount = 0;
+
+    //leaves are the only nodes not stored in the hash table
+    mNodes.push_back({noNode, noNode, noNode, noNode, noNode, noNode, 0, 0});
+    mNodes.push_back({noNode, noNode, noNode, noNode, noNode, noNode, 1, 0});
+    mRoot = createEmptyNode(3);
+}
+
+void HashLifeEngine::collectGarbage()
+{
+    //marks everything reachable from the root and from cached empty nodes...
+    std::vector<uint32_t> newIndices(mNodes.size(), noNode);
+    std::vector<uint32_t> nodesToVisit;
+    nodesToVisit.push_back(mRoot);
+    for (size_t i=0; i<mEmptyNodes.size(); i++)
+    {
+        if (mEmptyNodes[i] != noNode)
+        {
+            nodesToVisit.push_back(mEmptyNodes[i]);
+        }
+    }
+    newIndices[deadLeaf] = 0;
+    newIndices[aliveLeaf] = 0;
+    while (!nodesToVisit.empty())
+    {
+        uint32_t node = nodesToVisit.back();
+        nodesToVisit.pop_back();
+        if (newIndices[node] != noNode)
+        {
+            continue;
+        }
+        newIndices[node] = 0;
+        nodesToVisit.push_back(mNodes[node].nw);
+        nodesToVisit.push_back(mNodes[node].ne);
+        nodesToVisit.push_back(mNodes[node].sw);
+        nodesToVisit.push_back(mNodes[node].se);
+    }
+
+    //...then compacts them in place, children are always created before their parents, so they are already moved when the parent is
+    uint32_t nodeCount = 0;
+    for (uint32_t i=0; i<mNodes.size(); i++)
+    {
+        if (newIndices[i] == noNode)
+        {
+            continue;
+        }
+        newIndices[i] = nodeCount;
+        Node node = mNodes[i];
+        if (node.level > 0)
+        {
+            node.nw = newIndices[node.nw];
+            node.ne = newIndices[node.ne];
+            node.sw = newIndices[node.sw];
+            node.se = newIndices[node.se];
+        }
+        mNodes[nodeCount++] = node;
+    }
+    mNodes.resize(nodeCount);
+
+    //results are only a cache, the ones pointing at removed nodes are simply forgotten
+    for (uint32_t i=0; i<mNodes.size(); i++)
+    {
+        if (mNodes[i].result != noNode)
+        {
+            mNodes[i].result = newIndices[mNodes[i].result];
+        }
+    }
+    std::unordered_map<uint64_t, uint32_t> partialResults;
+    for (const auto& partialResult : mPartialResults)
+    {
+        uint32_t node = newIndices[partialResult.first >> 8];
+        uint32_t result = newIndices[partialResult.second];
+        if (node != noNode && result != noNode)
+        {
+            partialResults[((uint64_t)node << 8) | (partialResult.first & 0xFF)] = result;
+        }
+    }
+    mPartialResults.swap(partialResults);
+    mRoot = newIndices[mRoot];
+    for (size_t i=0; i<mEmptyNodes.size(); i++)
+    {
+        if (mEmptyNodes[i] != noNode)
+        {
+            mEmptyNodes[i] = newIndices[mEmptyNodes[i]];
+        }
+    }
+
+    size_t bucketCount = initialBucketCount;
+    while (bucketCount < mNodes.size())
+    {
+        bucketCount *= 2;
+    }
+    rehash(bucketCount);
+}
+
+uint32_t HashLifeEngine::calculateResult(uint32_t node)
+{
+    //squares small enough for a full step of 2^(level-2) generations have a future independent of the step size
+    bool isFullStep = mStepExponent >= mNodes[node].level-2;
+    uint64_t partialResultKey = ((uint64_t)node << 8) | (uint64_t)mStepExponent;
+    if (isFullStep && mNodes[node].result != noNode)
+    {
+        return mNodes[node].result;
+    }
+    if (!isFullStep)
+    {
+        auto partialResult = mPartialResults.find(partialResultKey);
+        if (partialResult != mPartialResults.end())
+        {
+            return partialResult->second;
+        }
+    }
+
+    //nodes are copied, not referenced, since creating new nodes may reallocate the whole vector
+    Node currentNode = mNodes[node];
+    uint32_t result;
+    if (currentNode.population == 0)
+    {
+        result = createEmptyNode(currentNode.level-1);
+    }
+    else if (currentNode.level == 2)
+    {
+        result = calculateBaseResult(node);
+    }
+    else
+    {
+        //nine overlapping squares of half the size, either advanced by their own results, or (for steps smaller than this node allows) only cropped
+        uint32_t squares[9] = {
+            currentNode.nw, createCenteredHorizontalSubnode(currentNode.nw, currentNode.ne), currentNode.ne,
+            createCenteredVerticalSubnode(currentNode.nw, currentNode.sw), createCenteredSubnode(node), createCenteredVerticalSubnode(currentNode.ne, currentNode.se),
+            currentNode.sw, createCenteredHorizontalSubnode(currentNode.sw, currentNode.se), currentNode.se};
+        for (int i=0; i<9; i++)
+        {
+            squares[i] = isFullStep ? calculateResult(squares[i]) : createCenteredSubnode(squares[i]);
+        }
+
+        uint32_t nw = calculateResult(createNode(squares[0], squares[1], squares[3], squares[4]));
+        uint32_t ne = calculateResult(createNode(squares[1], squares[2], squares[4], squares[5]));
+        uint32_t sw = calculateResult(createNode(squares[3], squares[4], squares[6], squares[7]));
+        uint32_t se = calculateResult(createNode(squares[4], squares[5], squares[7], squares[8]));
+        result = createNode(nw, ne, sw, se);
+    }
+
+    if (isFullStep)
+    {
+        mNodes[node].result = result;
+    }
+    else
+    {
+        mPartialResults[partialResultKey] = result;
+    }
+    return result;
+}
+
+uint32_t HashLifeEngine::calculateBaseResult(uint32_t node)
+{
+    //4x4 square is small enough to simply calculate one generation of its center 2x2 cells directly
+    int cells[4][4];
+    const Node& currentNode = mNodes[node];
+    uint32_t children[4] = {currentNode.nw, currentNode.ne, currentNode.sw, currentNode.se};
+    for (int i=0; i<4; i++)
+    {
+        const Node& child = mNodes[children[i]];
+        int x = (i%2)*2;
+        int y = (i/2)*2;
+        cells[y][x] = child.nw == aliveLeaf;
+        cells[y][x+1] = child.ne == aliveLeaf;
+        cells[y+1][x] = child.sw == aliveLeaf;
+        cells[y+1][x+1] = child.se == aliveLeaf;
+    }
+
+    uint32_t resultCells[4];
+    for (int i=0; i<4; i++)
+    {
+        int x = 1+i%2;
+        int y = 1+i/2;
+        int livingNeighboursCount = 0;
+        for (int j=-1; j<=1; j++)
+        {
+            for (int k=-1; k<=1; k++)
+            {
+                if (j != 0 || k != 0)
+                {
+                    livingNeighboursCount += cells[y+j][x+k];
+                }
+            }
+        }
+        bool isAlive = (cells[y][x] == 1) ? mRule.isSurvival(livingNeighboursCount) : mRule.isBirth(livingNeighboursCount);
+        resultCells[i] = isAlive ? aliveLeaf : deadLeaf;
+    }
+
+    return createNode(resultCells[0], resultCells[1], resultCells[2], resultCells[3]);
+}
+
+uint32_t HashLifeEngine::createCenteredSubnode(uint32_t node)
+{
+    const Node& currentNode = mNodes[node];
+    return createNode(mNodes[currentNode.nw].se, mNodes[currentNode.ne].sw, mNodes[currentNode.sw].ne, mNodes[currentNode.se].nw);
+}
+
+uint32_t HashLifeEngine::createCenteredHorizontalSubnode(uint32_t west, uint32_t east)
+{
+    return createNode(mNodes[west].ne, mNodes[east].nw, mNodes[west].se, mNodes[east].sw);
+}
+
+uint32_t HashLifeEngine::createCenteredVerticalSubnode(uint32_t north, uint32_t south)
+{
+    return createNode(mNodes[north].sw, mNodes[north].se, mNodes[south].nw, mNodes[south].ne);
+}
+
+uint32_t HashLifeEngine::expandUniverse(uint32_t node)
+{
+    Node currentNode = mNodes[node];
+    uint32_t border = createEmptyNode(currentNode.level-1);
+    uint32_t nw = createNode(border, border, border, currentNode.nw);
+    uint32_t ne = createNode(border, border, currentNode.ne, border);
+    uint32_t sw = createNode(border, currentNode.sw, border, border);
+    uint32_t se = createNode(currentNode.se, border, border, border);
+    return createNode(nw, ne, sw, se);
+}
+
+bool HashLifeEngine::isPopulationInCenterQuarter(uint32_t node)
+{
+    const Node& currentNode = mNodes[node];
+    uint64_t centerPopulation = mNodes[mNodes[mNodes[currentNode.nw].se].se].population
+                              + mNodes[mNodes[mNodes[currentNode.ne].sw].sw].population
+                              + mNodes[mNodes[mNodes[currentNode.sw].ne].ne].population
+                              + mNodes[mNodes[mNodes[currentNode.se].nw].nw].population;
+    return centerPopulation == currentNode.population;
+}
+
+uint32_t HashLifeEngine::buildNodeFromGrid(const CellGrid& cellGrid, int level, int64_t x, int64_t y)
+{
+    int64_t size = (int64_t)1 << level;
+    if (x >= mColumnCount || y >= mRowCount || x+size <= 0 || y+size <= 0)
+    {
+        return createEmptyNode(level);
+    }
+    if (level == 0)
+    {
+        return cellGrid.getCellValue((int)x, (int)y) == 1 ? aliveLeaf : deadLeaf;
+    }
+
+    int64_t halfSize = size/2;
+    uint32_t nw = buildNodeFromGrid(cellGrid, level-1, x, y);
+    uint32_t ne = buildNodeFromGrid(cellGrid, level-1, x+halfSize, y);
+    uint32_t sw = buildNodeFromGrid(cellGrid, level-1, x, y+halfSize);
+    uint32_t se = buildNodeFromGrid(cellGrid, level-1, x+halfSize, y+halfSize);
+    return createNode(nw, ne, sw, se);
+}
+
+void HashLifeEngine::writeNodeToGrid(CellGrid& cellGrid, uint32_t node, int64_t x, int64_t y)
+{
+    const Node& currentNode = mNodes[node];
+    if (currentNode.population == 0 || x >= mColumnCount || y >= mRowCount)
+    {
+        return;
+    }
+    if (currentNode.level == 0)
+    {
+        if (x >= 0 && y >= 0)
+        {
+            cellGrid.setCellValue((int)x, (int)y, 1);
+        }
+        return;
+    }
+
+    //squares entirely to the left or above the window are skipped without overflowing for huge universes
+    int64_t halfSize = (int64_t)1 << (currentNode.level-1);
+    if ((x < 0 && x+halfSize*2 <= 0) || (y < 0 && y+halfSize*2 <= 0))
+    {
+        return;
+    }
+    writeNodeToGrid(cellGrid, currentNode.nw, x, y);
+    writeNodeToGrid(cellGrid, currentNode.ne, x+halfSize, y);
+    writeNodeToGrid(cellGrid, currentNode.sw, x, y+halfSize);
+    writeNodeToGrid(cellGrid, currentNode.se, x+halfSize, y+halfSize);
+}
+
+void HashLifeEngine::setStepExponent(int exponent)
+{
+    if (exponent == mStepExponent)
+    {
+        return;
+    }
+
+    //results of both step sizes stay cached, calculateResult picks the right ones
+    mStepExponent = exponent;
+}
+
+void HashLifeEngine::clearResults()
+{
+    for (size_t i=0; i<mNodes.size(); i++)
+    {
+        mNodes[i].result = noNode;
+    }
+    mPartialResults.clear();
+}
+
+void HashLifeEngine::rehash(size_t bucketCount)
+{
+    mBuckets.assign(bucketCount, noNode);
+    for (uint32_t i=aliveLeaf+1; i<mNodes.size(); i++)
+    {
+        uint32_t bucket = (uint32_t)(hashChildren(mNodes[i].nw, mNodes[i].ne, mNodes[i].sw, mNodes[i].se) & (bucketCount-1));
+        mNodes[i].nextInBucket = mBuckets[bucket];
+        mBuckets[bucket] = i;
+    }
+}
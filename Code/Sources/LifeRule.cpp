@@ -0,0 +1,276 @@
+#include "../Headers/LifeRule.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    //reads digits 0-8 into a mask, stops at the first character which is not a digit
+    bool parseNeighbourCounts(const std::string& ruleString, size_t& position, uint16_t& mask)
+    {
+        mask = 0;
+        for (; position<ruleString.size() && ruleString[position]>='0' && ruleString[position]<='9'; position++)
+        {
+            if (ruleString[position] == '9')
+            {
+                return false;
+            }
+            mask |= 1 << (ruleString[position]-'0');
+        }
+        return true;
+    }
+
+    bool parseStateCount(const std::string& ruleString, size_t& position, int& stateCount)
+    {
+        size_t firstDigit = position;
+        stateCount = 0;
+        for (; position<ruleString.size() && ruleString[position]>='0' && ruleString[position]<='9' && stateCount<=LifeRule::maximumStateCount; position++)
+        {
+            stateCount = stateCount*10+(ruleString[position]-'0');
+        }
+        return position > firstDigit && stateCount >= 2 && stateCount <= LifeRule::maximumStateCount;
+    }
+
+    //reads a non-negative number of at most maximum, stops at the first character which is not a digit
+    bool parseNumber(const std::string& ruleString, size_t& position, int maximum, int& number)
+    {
+        size_t firstDigit = position;
+        number = 0;
+        for (; position<ruleString.size() && ruleString[position]>='0' && ruleString[position]<='9'; position++)
+        {
+            number = number*10+(ruleString[position]-'0');
+            if (number > maximum)
+            {
+                return false;
+            }
+        }
+        return position > firstDigit;
+    }
+
+    //reads "minimum..maximum" of neighbour counts
+    bool parseInterval(const std::string& ruleString, size_t& position, int maximum, int& intervalMinimum, int& intervalMaximum)
+    {
+        if (!parseNumber(ruleString, position, maximum, intervalMinimum) || ruleString.compare(position, 2, "..") != 0)
+        {
+            return false;
+        }
+        position += 2;
+        return parseNumber(ruleString, position, maximum, intervalMaximum);
+    }
+
+    //Larger than Life notation, comma separated parts, each starting with its letter
+    bool parseLargerThanLife(const std::string& ruleString, LifeRule& rule)
+    {
+        bool isRangeParsed = false, isStateCountParsed = false, isMiddleParsed = false;
+        bool isSurvivalParsed = false, isBirthParsed = false, isNeighbourhoodParsed = false;
+        int isMiddleCounted = 0;
+        size_t position = 0;
+        while (position < ruleString.size())
+        {
+            char part = ruleString[position++];
+            bool isParsed = false;
+            if (part == 'R' && !isRangeParsed)
+            {
+                isParsed = parseNumber(ruleString, position, LifeRule::maximumRange, rule.range) && rule.range >= 1;
+                isRangeParsed = true;
+            }
+            else if (part == 'C' && !isStateCountParsed)
+            {
+                //C0 and C1 mean no dying states, just as C2
+                isParsed = parseNumber(ruleString, position, LifeRule::maximumStateCount, rule.stateCount);
+                rule.stateCount = std::max(rule.stateCount, 2);
+                isStateCountParsed = true;
+            }
+            else if (part == 'M' && !isMiddleParsed)
+            {
+                isParsed = parseNumber(ruleString, position, 1, isMiddleCounted);
+                isMiddleParsed = true;
+            }
+            else if (part == 'S' && !isSurvivalParsed)
+            {
+                isParsed = parseInterval(ruleString, position, 2*LifeRule::maximumRange*(2*LifeRule::maximumRange+2)+1, rule.survivalMinimum, rule.survivalMaximum);
+                isSurvivalParsed = true;
+            }
+            else if (part == 'B' && !isBirthParsed)
+            {
+                isParsed = parseInterval(ruleString, position, 2*LifeRule::maximumRange*(2*LifeRule::maximumRange+2)+1, rule.birthMinimum, rule.birthMaximum);
+                isBirthParsed = true;
+            }
+            else if (part == 'N' && !isNeighbourhoodParsed && position < ruleString.size())
+            {
+                char neighbourhood = ruleString[position++];
+                rule.neighbourhood = (neighbourhood == 'N') ? LifeNeighbourhood::vonNeumann : LifeNeighbourhood::moore;
+                isParsed = neighbourhood == 'M' || neighbourhood == 'N';
+                isNeighbourhoodParsed = true;
+            }
+            if (!isParsed || (position < ruleString.size() && ruleString[position++] != ','))
+            {
+                return false;
+            }
+        }
+        if (!isRangeParsed || !isSurvivalParsed || !isBirthParsed || ruleString.back() == ',')
+        {
+            return false;
+        }
+
+        //middle cell counts itself only while it is alive, so such survival counts are stored as counts of its neighbours
+        if (isMiddleCounted)
+        {
+            rule.survivalMinimum = std::max(rule.survivalMinimum-1, 0);
+            rule.survivalMaximum--;
+        }
+        //every empty interval is stored the same way, so equal rules compare equal
+        if (rule.survivalMinimum > rule.survivalMaximum)
+        {
+            rule.survivalMinimum = 1;
+            rule.survivalMaximum = 0;
+        }
+        if (rule.birthMinimum > rule.birthMaximum)
+        {
+            rule.birthMinimum = 1;
+            rule.birthMaximum = 0;
+        }
+        //range 1 Moore rules are plain Life-like ones, which every engine supports
+        if (!rule.hasExtendedNeighbourhood())
+        {
+            for (int i=0; i<=8; i++)
+            {
+                rule.birthMask |= (i >= rule.birthMinimum && i <= rule.birthMaximum) ? 1 << i : 0;
+                rule.survivalMask |= (i >= rule.survivalMinimum && i <= rule.survivalMaximum) ? 1 << i : 0;
+            }
+            rule.birthMinimum = rule.birthMaximum = rule.survivalMinimum = rule.survivalMaximum = 0;
+        }
+        return true;
+    }
+}
+
+int LifeRule::getNeighbourCount() const
+{
+    if (neighbourhood == LifeNeighbourhood::vonNeumann)
+    {
+        return 2*range*(range+1);
+    }
+    return (2*range+1)*(2*range+1)-1;
+}
+
+LifeRule LifeRule::conway()
+{
+    return LifeRule{1 << 3, (1 << 2) | (1 << 3), 2};
+}
+
+bool LifeRule::parse(const std::string& ruleString, LifeRule& rule)
+{
+    std::string upperCaseRuleString = ruleString;
+    for (char& character : upperCaseRuleString)
+    {
+        character = (char)std::toupper((unsigned char)character);
+    }
+
+    LifeRule parsedRule{0, 0, 2};
+    size_t position = 0;
+    if (!upperCaseRuleString.empty() && upperCaseRuleString[0] == 'R')
+    {
+        if (!parseLargerThanLife(upperCaseRuleString, parsedRule))
+        {
+            return false;
+        }
+        position = upperCaseRuleString.size();
+    }
+    else if (!upperCaseRuleString.empty() && upperCaseRuleString[0] != 'B' && upperCaseRuleString[0] != 'S')
+    {
+        //old notation lists survival counts first and has no letters at all, Generations rules add the state count as the third part
+        if (!parseNeighbourCounts(upperCaseRuleString, position, parsedRule.survivalMask) || position >= upperCaseRuleString.size() || upperCaseRuleString[position] != '/')
+        {
+            return false;
+        }
+        position++;
+        if (!parseNeighbourCounts(upperCaseRuleString, position, parsedRule.birthMask))
+        {
+            return false;
+        }
+        if (position < upperCaseRuleString.size() && (upperCaseRuleString[position] != '/' || !parseStateCount(upperCaseRuleString, ++position, parsedRule.stateCount)))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        //birth and survival parts are required, in either order, state count is optional and always last, parts may be separated by slashes
+        bool isBirthParsed = false;
+        bool isSurvivalParsed = false;
+        bool isStateCountParsed = false;
+        while (position < upperCaseRuleString.size())
+        {
+            char part = upperCaseRuleString[position++];
+            bool isParsed = false;
+            if (part == 'B' && !isBirthParsed && !isStateCountParsed)
+            {
+                isParsed = parseNeighbourCounts(upperCaseRuleString, position, parsedRule.birthMask);
+                isBirthParsed = true;
+            }
+            else if (part == 'S' && !isSurvivalParsed && !isStateCountParsed)
+            {
+                isParsed = parseNeighbourCounts(upperCaseRuleString, position, parsedRule.survivalMask);
+                isSurvivalParsed = true;
+            }
+            else if ((part == 'C' || part == 'G') && isBirthParsed && isSurvivalParsed && !isStateCountParsed)
+            {
+                isParsed = parseStateCount(upperCaseRuleString, position, parsedRule.stateCount);
+                isStateCountParsed = true;
+            }
+            if (!isParsed)
+            {
+                return false;
+            }
+            if (position < upperCaseRuleString.size() && upperCaseRuleString[position] == '/' && position+1 < upperCaseRuleString.size())
+            {
+                position++;
+            }
+        }
+        if (!isBirthParsed || !isSurvivalParsed)
+        {
+            return false;
+        }
+    }
+
+    if (position != upperCaseRuleString.size())
+    {
+        return false;
+    }
+    rule = parsedRule;
+    return true;
+}
+
+std::string LifeRule::toString() const
+{
+    if (hasExtendedNeighbourhood())
+    {
+        //survival counts never include the middle cell, so M is always 0
+        return "R"+std::to_string(range)+",C"+std::to_string(isGenerations() ? stateCount : 0)+",M0"
+             +",S"+std::to_string(survivalMinimum)+".."+std::to_string(survivalMaximum)
+             +",B"+std::to_string(birthMinimum)+".."+std::to_string(birthMaximum)
+             +",N"+((neighbourhood == LifeNeighbourhood::vonNeumann) ? "N" : "M");
+    }
+
+    std::string ruleString = "B";
+    for (int i=0; i<=8; i++)
+    {
+        if (isBirth(i))
+        {
+            ruleString += (char)('0'+i);
+        }
+    }
+    ruleString += "/S";
+    for (int i=0; i<=8; i++)
+    {
+        if (isSurvival(i))
+        {
+            ruleString += (char)('0'+i);
+        }
+    }
+    if (isGenerations())
+    {
+        ruleString += "/C"+std::to_string(stateCount);
+    }
+    return ruleString;
+}
@@ -0,0 +1,506 @@
+#include "../Headers/MacrocellFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+//cells of larger squares would not have 64-bit coordinates
+#define maximumMacrocellLevel 62
+//written text is handed over to the file in chunks of about this many bytes
+#define macrocellWriteChunkSize (1 << 20)
+
+namespace
+{
+    struct MacrocellSquare
+    {
+        int level;
+        bool isLeaf;//8x8 square stored as a bitmap
+        uint32_t children[4];//nw, ne, sw, se line numbers, or cell states for level 1 squares of Generations patterns
+        uint64_t leafCells;//bit 8*row+column
+        //bounding box of living cells relative to the top left corner of the square, empty if left is greater than right
+        int64_t left, top, right, bottom;
+    };
+
+    //reads the file line by line, so even files of gigabytes are never held in memory at once, every 8x8 square is passed to addLeaf
+    //and every larger square to addNode (children are already validated), both return false to stop reading,
+    //generation count is the one of a "#G" line, 0 without it
+    template <typename AddLeafFunction, typename AddNodeFunction>
+    bool parseMacrocell(std::istream& file, LifeRule& rule, uint64_t& generationCount, AddLeafFunction addLeaf, AddNodeFunction addNode)
+    {
+        generationCount = 0;
+        std::string line;
+        if (!std::getline(file, line) || line.compare(0, 4, "[M2]") != 0)
+        {
+            std::cout << "Macrocell file has to start with [M2]" << std::endl;
+            return false;
+        }
+
+        //level of every square by its line number, line number 0 stands for an empty square of any level
+        std::vector<uint8_t> squareLevels(1, 0);
+        uint64_t lineNumber = 1;
+        while (std::getline(file, line))
+        {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line.empty())
+            {
+                continue;
+            }
+
+            if (line[0] == '#')
+            {
+                if (line.size() > 1 && (line[1] == 'R' || line[1] == 'r'))
+                {
+                    std::string ruleString = line.substr(2);
+                    std::erase_if(ruleString, [](char character) { return character == ' ' || character == '\t'; });
+                    LifeRule fileRule;
+                    if (LifeRule::parse(ruleString, fileRule))
+                    {
+                        rule = fileRule;
+                    }
+                    else
+                    {
+                        std::cout << "Rule " << ruleString << " of the pattern is not supported, keeping rule " << rule.toString() << std::endl;
+                    }
+                }
+                else if (line.size() > 1 && (line[1] == 'G' || line[1] == 'g'))
+                {
+                    //a wrong generation count only loses the count, the pattern itself is still fine
+                    size_t firstDigit = line.find_first_not_of(" \t", 2);
+                    const char* lineEnd = line.data()+line.size();
+                    std::from_chars_result result = std::from_chars(line.data()+std::min(firstDigit, line.size()), lineEnd, generationCount);
+                    if (firstDigit == std::string::npos || result.ec != std::errc() || line.find_first_not_of(" \t", result.ptr-line.data()) != std::string::npos)
+                    {
+                        generationCount = 0;
+                        std::cout << "Generation count " << line.substr(std::min(firstDigit, line.size())) << " of the pattern is not valid, starting from generation 0" << std::endl;
+                    }
+                }
+                continue;
+            }
+
+            if (squareLevels.size() > UINT32_MAX)
+            {
+                std::cout << "Macrocell file has too many squares" << std::endl;
+                return false;
+            }
+
+            if (line[0] == '.' || line[0] == '*' || line[0] == '$')
+            {
+                uint64_t cells = 0;
+                int column = 0, row = 0;
+                for (char character : line)
+                {
+                    if (character == '$')
+                    {
+                        row++;
+                        column = 0;
+                        continue;
+                    }
+                    if ((character != '.' && character != '*') || column >= 8 || row >= 8)
+                    {
+                        std::cout << "Invalid 8x8 square on line " << lineNumber << " of macrocell file" << std::endl;
+                        return false;
+                    }
+                    if (character == '*')
+                    {
+                        cells |= (uint64_t)1 << (8*row+column);
+                    }
+                    column++;
+                }
+                squareLevels.push_back(3);
+                if (!addLeaf(cells))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            //"level nw ne sw se"
+            uint64_t numbers[5];
+            const char* position = line.data();
+            const char* lineEnd = line.data()+line.size();
+            for (uint64_t& number : numbers)
+            {
+                while (position < lineEnd && *position == ' ')
+                {
+                    position++;
+                }
+                std::from_chars_result result = std::from_chars(position, lineEnd, number);
+                if (result.ec != std::errc())
+                {
+                    std::cout << "Invalid square on line " << lineNumber << " of macrocell file" << std::endl;
+                    return false;
+                }
+                position = result.ptr;
+            }
+            int level = (int)std::min(numbers[0], (uint64_t)maximumMacrocellLevel+1);
+            if (level < 1 || level > maximumMacrocellLevel)
+            {
+                std::cout << "Invalid level of square on line " << lineNumber << " of macrocell file" << std::endl;
+                return false;
+            }
+            uint32_t children[4];
+            for (int i=0; i<4; i++)
+            {
+                uint64_t child = numbers[i+1];
+                bool isValid = (level == 1) ? child < (uint64_t)rule.stateCount : (child < squareLevels.size() && (child == 0 || squareLevels[child] == level-1));
+                if (!isValid)
+                {
+                    std::cout << "Invalid " << (level == 1 ? "cell state" : "child square") << " on line " << lineNumber << " of macrocell file" << std::endl;
+                    return false;
+                }
+                children[i] = (uint32_t)child;
+            }
+            squareLevels.push_back((uint8_t)level);
+            if (!addNode(level, children))
+            {
+                return false;
+            }
+        }
+
+        if (squareLevels.size() == 1)
+        {
+            std::cout << "Macrocell file contains no squares" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t buildLeafSquare(HashLifeEngine& hashLifeEngine, uint64_t cells, int level, int column, int row)
+    {
+        if (level == 0)
+        {
+            return ((cells >> (8*row+column)) & 1) ? HashLifeEngine::aliveLeaf : HashLifeEngine::deadLeaf;
+        }
+        int halfSize = 1 << (level-1);
+        return hashLifeEngine.createNode(buildLeafSquare(hashLifeEngine, cells, level-1, column, row), buildLeafSquare(hashLifeEngine, cells, level-1, column+halfSize, row),
+                                         buildLeafSquare(hashLifeEngine, cells, level-1, column, row+halfSize), buildLeafSquare(hashLifeEngine, cells, level-1, column+halfSize, row+halfSize));
+    }
+
+    void readLeafSquare(const HashLifeEngine& hashLifeEngine, uint32_t node, int column, int row, uint64_t& cells)
+    {
+        const HashLifeEngine::Node& square = hashLifeEngine.getNode(node);
+        if (square.population == 0)
+        {
+            return;
+        }
+        if (square.level == 0)
+        {
+            cells |= (uint64_t)1 << (8*row+column);
+            return;
+        }
+        int halfSize = 1 << (square.level-1);
+        readLeafSquare(hashLifeEngine, square.nw, column, row, cells);
+        readLeafSquare(hashLifeEngine, square.ne, column+halfSize, row, cells);
+        readLeafSquare(hashLifeEngine, square.sw, column, row+halfSize, cells);
+        readLeafSquare(hashLifeEngine, square.se, column+halfSize, row+halfSize, cells);
+    }
+
+    //parses the whole file into a table of squares with their bounding boxes, which takes memory proportional to the file, not to the universe
+    bool readMacrocellSquares(const std::string& filepath, std::vector<MacrocellSquare>& squares, LifeRule& rule)
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cout << "Cannot open pattern file " << filepath << std::endl;
+            return false;
+        }
+
+        squares.assign(1, MacrocellSquare{0, false, {0, 0, 0, 0}, 0, 1, 1, 0, 0});
+        uint64_t generationCount = 0;//dense boards do not keep it, only HashLife does
+        auto addBoundingBox = [](MacrocellSquare& square, int64_t left, int64_t top, int64_t right, int64_t bottom)
+        {
+            if (left > right)
+            {
+                return;
+            }
+            if (square.left > square.right)
+            {
+                square.left = left;
+                square.top = top;
+                square.right = right;
+                square.bottom = bottom;
+                return;
+            }
+            square.left = std::min(square.left, left);
+            square.top = std::min(square.top, top);
+            square.right = std::max(square.right, right);
+            square.bottom = std::max(square.bottom, bottom);
+        };
+        auto addLeaf = [&](uint64_t cells)
+        {
+            MacrocellSquare square{3, true, {0, 0, 0, 0}, cells, 1, 1, 0, 0};
+            for (int i=0; i<64; i++)
+            {
+                if ((cells >> i) & 1)
+                {
+                    addBoundingBox(square, i%8, i/8, i%8, i/8);
+                }
+            }
+            squares.push_back(square);
+            return true;
+        };
+        auto addNode = [&](int level, const uint32_t* children)
+        {
+            MacrocellSquare square{level, false, {children[0], children[1], children[2], children[3]}, 0, 1, 1, 0, 0};
+            int64_t halfSize = (int64_t)1 << (level-1);
+            for (int i=0; i<4; i++)
+            {
+                int64_t x = (i%2)*halfSize;
+                int64_t y = (i/2)*halfSize;
+                if (level == 1)
+                {
+                    if (children[i] != 0)
+                    {
+                        addBoundingBox(square, x, y, x, y);
+                    }
+                }
+                else
+                {
+                    const MacrocellSquare& child = squares[children[i]];
+                    addBoundingBox(square, x+child.left, y+child.top, x+child.right, y+child.bottom);
+                }
+            }
+            squares.push_back(square);
+            return true;
+        };
+        if (!parseMacrocell(file, rule, generationCount, addLeaf, addNode))
+        {
+            std::cout << "Cannot load pattern file " << filepath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    //(x, y) is the position of the top left corner of the square on the grid, squares without living cells on the grid are skipped whole
+    void rasterizeSquare(const std::vector<MacrocellSquare>& squares, uint32_t index, int64_t x, int64_t y, CellGrid& cellGrid)
+    {
+        const MacrocellSquare& square = squares[index];
+        if (index == 0 || square.left > square.right || x+square.right < 0 || y+square.bottom < 0 ||
+            x+square.left >= cellGrid.getColumnCount() || y+square.top >= cellGrid.getRowCount())
+        {
+            return;
+        }
+
+        if (square.isLeaf)
+        {
+            for (int i=0; i<64; i++)
+            {
+                if (((square.leafCells >> i) & 1) && cellGrid.containsCell((int)(x+i%8), (int)(y+i/8)))
+                {
+                    cellGrid.setCellValue((int)(x+i%8), (int)(y+i/8), 1);
+                }
+            }
+            return;
+        }
+        int64_t halfSize = (int64_t)1 << (square.level-1);
+        for (int i=0; i<4; i++)
+        {
+            int64_t childX = x+(i%2)*halfSize;
+            int64_t childY = y+(i/2)*halfSize;
+            if (square.level == 1)
+            {
+                if (square.children[i] != 0 && cellGrid.containsCell((int)childX, (int)childY))
+                {
+                    cellGrid.setCellValue((int)childX, (int)childY, (int)square.children[i]);
+                }
+            }
+            else
+            {
+                rasterizeSquare(squares, square.children[i], childX, childY, cellGrid);
+            }
+        }
+    }
+}
+
+bool MacrocellFile::isMacrocell(const std::string& filepath)
+{
+    return filepath.size() >= 3 && (filepath.compare(filepath.size()-3, 3, ".mc") == 0 || filepath.compare(filepath.size()-3, 3, ".MC") == 0);
+}
+
+bool MacrocellFile::load(const std::string& filepath, HashLifeEngine& hashLifeEngine, LifeRule& rule)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Cannot open pattern file " << filepath << std::endl;
+        return false;
+    }
+
+    //squares go straight into the hash table of the engine, so identical squares found in the file are shared as well
+    hashLifeEngine.clear();
+    std::vector<uint32_t> engineNodes(1, HashLifeEngine::noNode);
+    uint64_t generationCount = 0;
+    auto addLeaf = [&](uint64_t cells)
+    {
+        engineNodes.push_back(buildLeafSquare(hashLifeEngine, cells, 3, 0, 0));
+        return true;
+    };
+    auto addNode = [&](int level, const uint32_t* children)
+    {
+        if (level < 4)
+        {
+            std::cout << "HashLife only simulates two cell states, so it cannot load Generations macrocell files" << std::endl;
+            return false;
+        }
+        uint32_t engineChildren[4];
+        for (int i=0; i<4; i++)
+        {
+            engineChildren[i] = children[i] == 0 ? hashLifeEngine.createEmptyNode(level-1) : engineNodes[children[i]];
+        }
+        engineNodes.push_back(hashLifeEngine.createNode(engineChildren[0], engineChildren[1], engineChildren[2], engineChildren[3]));
+        return true;
+    };
+    if (!parseMacrocell(file, rule, generationCount, addLeaf, addNode))
+    {
+        hashLifeEngine.clear();
+        std::cout << "Cannot load pattern file " << filepath << std::endl;
+        return false;
+    }
+
+    hashLifeEngine.setRoot(engineNodes.back());
+    hashLifeEngine.setGenerationCount(generationCount);
+    return true;
+}
+
+bool MacrocellFile::load(const std::string& filepath, CellGrid& cellGrid, LifeRule& rule)
+{
+    std::vector<MacrocellSquare> squares;
+    if (!readMacrocellSquares(filepath, squares, rule))
+    {
+        return false;
+    }
+
+    const MacrocellSquare& root = squares.back();
+    if (root.left > root.right)
+    {
+        cellGrid.resize(1, 1);
+        cellGrid.clear();
+        return true;
+    }
+    int64_t columnCount = root.right-root.left+1;
+    int64_t rowCount = root.bottom-root.top+1;
+    if (columnCount > (1 << 30) || rowCount > (1 << 30) || columnCount*rowCount > ((int64_t)1 << 32))
+    {
+        std::cout << "Pattern of " << columnCount << "x" << rowCount << " cells is too large for a dense board, load it into HashLife or load a window of it instead" << std::endl;
+        return false;
+    }
+
+    try
+    {
+        cellGrid.resize((int)columnCount, (int)rowCount);
+    }
+    catch (const std::bad_alloc&)
+    {
+        std::cout << "Not enough memory for a board of " << columnCount << "x" << rowCount << " cells, load it into HashLife or load a window of it instead" << std::endl;
+        return false;
+    }
+    cellGrid.clear();
+    rasterizeSquare(squares, (uint32_t)(squares.size()-1), -root.left, -root.top, cellGrid);
+    return true;
+}
+
+bool MacrocellFile::loadWindow(const std::string& filepath, int64_t left, int64_t top, CellGrid& cellGrid, LifeRule& rule)
+{
+    //universes are at most 2^maximumMacrocellLevel cells wide, so positions of their squares relative to such windows never overflow
+    if (left < -((int64_t)1 << 62) || left > ((int64_t)1 << 62) || top < -((int64_t)1 << 62) || top > ((int64_t)1 << 62))
+    {
+        std::cout << "Window at " << left << ", " << top << " is outside of any macrocell universe, coordinates have to be within +-2^62" << std::endl;
+        return false;
+    }
+
+    std::vector<MacrocellSquare> squares;
+    if (!readMacrocellSquares(filepath, squares, rule))
+    {
+        return false;
+    }
+
+    cellGrid.clear();
+    int64_t halfSize = (int64_t)1 << (squares.back().level-1);
+    rasterizeSquare(squares, (uint32_t)(squares.size()-1), -halfSize-left, -halfSize-top, cellGrid);
+    return true;
+}
+
+bool MacrocellFile::save(const std::string& filepath, const HashLifeEngine& hashLifeEngine, const LifeRule& rule)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Cannot create pattern file " << filepath << std::endl;
+        return false;
+    }
+
+    std::string content = "[M2] (GameOfLife)\n#R "+rule.toString()+"\n";
+    if (hashLifeEngine.getGenerationCount() > 0)
+    {
+        content += "#G "+std::to_string(hashLifeEngine.getGenerationCount())+"\n";
+    }
+
+    //every distinct square is written once, after its children, empty squares are never written at all
+    std::vector<uint32_t> lineNumbers(hashLifeEngine.getNodeCount(), 0);
+    uint32_t nextLineNumber = 1;
+    auto writeSquare = [&](auto& writeSquare, uint32_t node) -> uint32_t
+    {
+        const HashLifeEngine::Node& square = hashLifeEngine.getNode(node);
+        if (square.population == 0)
+        {
+            return 0;
+        }
+        if (lineNumbers[node] != 0)
+        {
+            return lineNumbers[node];
+        }
+
+        if (square.level == 3)
+        {
+            uint64_t cells = 0;
+            readLeafSquare(hashLifeEngine, node, 0, 0, cells);
+            //dead cells at the end of a row and empty rows at the end of the square are left out
+            int lastRow = 7;
+            while (((cells >> (8*lastRow)) & 0xFF) == 0)
+            {
+                lastRow--;
+            }
+            for (int row=0; row<=lastRow; row++)
+            {
+                uint64_t rowCells = (cells >> (8*row)) & 0xFF;
+                for (int column=0; rowCells >> column != 0; column++)
+                {
+                    content += ((rowCells >> column) & 1) ? '*' : '.';
+                }
+                content += '$';
+            }
+        }
+        else
+        {
+            uint32_t nw = writeSquare(writeSquare, square.nw);
+            uint32_t ne = writeSquare(writeSquare, square.ne);
+            uint32_t sw = writeSquare(writeSquare, square.sw);
+            uint32_t se = writeSquare(writeSquare, square.se);
+            content += std::to_string(square.level)+" "+std::to_string(nw)+" "+std::to_string(ne)+" "+std::to_string(sw)+" "+std::to_string(se);
+        }
+        content += '\n';
+        if (content.size() > macrocellWriteChunkSize)
+        {
+            file << content;
+            content.clear();
+        }
+
+        lineNumbers[node] = nextLineNumber++;
+        return lineNumbers[node];
+    };
+
+    //top square is always written, even if the universe is empty
+    if (writeSquare(writeSquare, hashLifeEngine.getRoot()) == 0)
+    {
+        content += "$\n";
+    }
+    file << content;
+    return file.good();
+}
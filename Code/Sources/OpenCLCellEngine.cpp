@@ -0,0 +1,319 @@
+#include "../Headers/OpenCLCellEngine.h"
+
+OpenCLCellEngine::OpenCLCellEngine(OpenCLKernelVariant kernelVariant)
+:mColumnCount(0),
+mRowCount(0),
+mColumnStride(0),
+mDeviceCellBufferCapacity(0),
+mDeviceSumBufferCapacity(0),
+mKernelVariant(kernelVariant),
+mTopology(BoardTopology::deadBorder),
+mRule(LifeRule::conway()),
+mWordsPerColumn(0)
+{
+    //sets default platform and device to use for kernel calculations, allDevicesOnDefaultPlatform[0] is CPU, allDevicesOnDefaultPlatform[1] is GPU
+    std::vector<cl::Platform> allPlatforms = OpenCLFunctions::getAllPlatforms();
+    mOpenCLObject.platform = allPlatforms[0];
+    std::vector<cl::Device> allDevicesOnDefaultPlatform = OpenCLFunctions::getAllDevicesOnPlatform(mOpenCLObject.platform);
+    //GPU should generally be used whenever available, but not every PC has a separate GPU
+    if (allDevicesOnDefaultPlatform.size() < 2)
+    {
+        mOpenCLObject.device = allDevicesOnDefaultPlatform[0];
+    }
+    else
+    {
+        mOpenCLObject.device = allDevicesOnDefaultPlatform[1];
+    }
+
+    //sets OpenCL context and begins allocating memory on the device using OpenCL buffer objects, cell buffers are allocated once the board size is known
+    mOpenCLObject.context = cl::Context({mOpenCLObject.device});
+    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceColumnCount, 1*sizeof(int), mOpenCLObject.context);
+    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceRowCount, 1*sizeof(int), mOpenCLObject.context);
+    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceColumnStride, 1*sizeof(int), mOpenCLObject.context);
+    OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceTopology, 1*sizeof(int), mOpenCLObject.context);
+
+    //sets remaining OpenCL objects, the kernel itself is created together with cell buffers
+    buildProgramForRule();
+    mOpenCLObject.commandQueue = cl::CommandQueue(mOpenCLObject.context, mOpenCLObject.device);
+}
+
+void OpenCLCellEngine::setCells(const CellGrid& cellGrid)
+{
+    //kernel is missing right after the program was rebuilt for a new rule
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount || (mKernelVariant != OpenCLKernelVariant::bitPacked && cellGrid.getColumnStride() != mColumnStride)
+        || mOpenCLObject.kernelCell() == nullptr)
+    {
+        mColumnCount = cellGrid.getColumnCount();
+        mRowCount = cellGrid.getRowCount();
+        updateOpenCLObjectToMatchColumnsAndRows(cellGrid.getColumnStride());
+    }
+    //kernels only wrap cells lying next to the board, so the topology costs nothing for the rest of them
+    int arrayFormTopology[1] = {(int)mTopology};
+    OpenCLFunctions::sendDataToDevice((void*)arrayFormTopology, mOpenCLObject.deviceTopology, 1*sizeof(int), mOpenCLObject.commandQueue);
+
+    if (mKernelVariant != OpenCLKernelVariant::bitPacked)
+    {
+        //cell grid already uses the layout expected by the kernel, so it can be sent to the device as it is
+        OpenCLFunctions::sendDataToDevice((void*)cellGrid.getData(), mOpenCLObject.deviceInputCellValues, cellGrid.getDataSize(), mOpenCLObject.commandQueue);
+        return;
+    }
+
+    std::fill(mPackedCellValues.begin(), mPackedCellValues.end(), 0);
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            if (cellGrid.getCellValue(i, j) == 1)
+            {
+                mPackedCellValues[(size_t)i*mColumnStride+j/32] |= 1u << (j%32);
+            }
+        }
+    }
+    OpenCLFunctions::sendDataToDevice((void*)mPackedCellValues.data(), mOpenCLObject.deviceInputCellValues, getDeviceCellBufferSize(), mOpenCLObject.commandQueue);
+}
+
+void OpenCLCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        //sums of living cells have to be complete before any cell is calculated, kernels of one queue run in order
+        if (isLargerThanLifeKernelUsed())
+        {
+            OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelColumnSums, 4, {mOpenCLObject.deviceInputCellValues});
+            OpenCLFunctions::startKernel(mOpenCLObject.kernelColumnSums, mOpenCLObject.commandQueue, cl::NullRange, cl::NDRange(mColumnCount+2*mRule.range));
+            if (mRule.neighbourhood == LifeNeighbourhood::moore)
+            {
+                OpenCLFunctions::startKernel(mOpenCLObject.kernelAreaSums, mOpenCLObject.commandQueue, cl::NullRange, cl::NDRange(mRowCount+2*mRule.range+1));
+            }
+            else
+            {
+                OpenCLFunctions::startKernel(mOpenCLObject.kernelDiagonalSums, mOpenCLObject.commandQueue, cl::NullRange, cl::NDRange(mColumnCount+mRowCount+4*mRule.range-1));
+            }
+        }
+
+        //begins calculating new cell values for every cell
+        OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelCell, 4, {mOpenCLObject.deviceInputCellValues, mOpenCLObject.deviceOutputCellValues});
+        OpenCLFunctions::startKernel(mOpenCLObject.kernelCell, mOpenCLObject.commandQueue, mOpenCLObject.localWorkGroupSize, mOpenCLObject.globalWorkGroupSize);
+
+        //buffers swap roles, so the new generation becomes the input of the next one without being copied or leaving the device
+        std::swap(mOpenCLObject.deviceInputCellValues, mOpenCLObject.deviceOutputCellValues);
+    }
+
+    //kernels are only flushed here, the host waits for them only once it actually reads cells back
+    mOpenCLObject.commandQueue.flush();
+}
+
+void OpenCLCellEngine::finish()
+{
+    mOpenCLObject.commandQueue.finish();
+}
+
+void OpenCLCellEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+
+    if (mKernelVariant != OpenCLKernelVariant::bitPacked && cellGrid.getColumnStride() == mColumnStride)
+    {
+        OpenCLFunctions::getDataFromDevice((void*)cellGrid.getData(), mOpenCLObject.deviceInputCellValues, cellGrid.getDataSize(), mOpenCLObject.commandQueue);
+        return;
+    }
+    if (mKernelVariant != OpenCLKernelVariant::bitPacked)
+    {
+        mStagingCellValues.resize((size_t)mColumnCount*mColumnStride);
+        OpenCLFunctions::getDataFromDevice((void*)mStagingCellValues.data(), mOpenCLObject.deviceInputCellValues, getDeviceCellBufferSize(), mOpenCLObject.commandQueue);
+        for (int i=0; i<mColumnCount; i++)
+        {
+            std::copy_n(&mStagingCellValues[(size_t)i*mColumnStride], mRowCount, cellGrid.getData()+(size_t)i*cellGrid.getColumnStride());
+        }
+        return;
+    }
+
+    OpenCLFunctions::getDataFromDevice((void*)mPackedCellValues.data(), mOpenCLObject.deviceInputCellValues, getDeviceCellBufferSize(), mOpenCLObject.commandQueue);
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            cellGrid.setCellValue(i, j, (int)((mPackedCellValues[(size_t)i*mColumnStride+j/32] >> (j%32)) & 1));
+        }
+    }
+}
+
+void OpenCLCellEngine::setTopology(BoardTopology topology)
+{
+    mTopology = topology;
+}
+
+void OpenCLCellEngine::setRule(const LifeRule& rule)
+{
+    if (rule == mRule)
+    {
+        return;
+    }
+    mRule = rule;
+    buildProgramForRule();
+    mOpenCLObject.kernelCell = cl::Kernel();
+}
+
+bool OpenCLCellEngine::isRuleSupported(const LifeRule& rule) const
+{
+    //single bit per cell cannot hold dying states of Generations rules, Larger than Life rules have their own kernel counting neighbours
+    //from sums of living cells kept in global memory
+    if (mKernelVariant == OpenCLKernelVariant::bitPacked)
+    {
+        return !rule.isGenerations() && !rule.hasExtendedNeighbourhood();
+    }
+    return mKernelVariant == OpenCLKernelVariant::globalMemory || !rule.hasExtendedNeighbourhood();
+}
+
+std::string OpenCLCellEngine::getName() const
+{
+    if (mKernelVariant == OpenCLKernelVariant::localMemory)
+    {
+        return "OpenCL (local memory tiles)";
+    }
+    if (mKernelVariant == OpenCLKernelVariant::bitPacked)
+    {
+        return "OpenCL (bit-packed)";
+    }
+    return "OpenCL";
+}
+
+size_t OpenCLCellEngine::getDeviceCellBufferSize() const
+{
+    if (mKernelVariant == OpenCLKernelVariant::bitPacked)
+    {
+        return (size_t)mColumnCount*mColumnStride*sizeof(uint32_t);
+    }
+    return (size_t)mColumnCount*mColumnStride*sizeof(uint8_t);
+}
+
+bool OpenCLCellEngine::isLargerThanLifeKernelUsed() const
+{
+    return mKernelVariant == OpenCLKernelVariant::globalMemory && mRule.hasExtendedNeighbourhood();
+}
+
+int OpenCLCellEngine::getVonNeumannRowsPerWorkItem() const
+{
+    //first cell of every work item counts its whole diamond, so work items go down at least as many cells as the diamond is high
+    return std::max(32, 2*mRule.range+1);
+}
+
+void OpenCLCellEngine::updateOpenCLObjectToMatchColumnsAndRows(int gridColumnStride)
+{
+    //bit-packed columns follow the capacity of the grid as well, so they do not move around every time a row is added
+    mWordsPerColumn = (mRowCount+31)/32;
+    mColumnStride = (mKernelVariant == OpenCLKernelVariant::bitPacked) ? (gridColumnStride+31)/32 : gridColumnStride;
+    if (mKernelVariant == OpenCLKernelVariant::bitPacked)
+    {
+        mPackedCellValues.assign((size_t)mColumnCount*mColumnStride, 0);
+    }
+
+    //buffers at least double whenever they run out of space and are never shrunk, so most resizes only update sizes kept on the device
+    if (getDeviceCellBufferSize() > mDeviceCellBufferCapacity)
+    {
+        mDeviceCellBufferCapacity = std::max(getDeviceCellBufferSize(), mDeviceCellBufferCapacity*2);
+        mOpenCLObject.deviceInputCellValues = cl::Buffer();
+        mOpenCLObject.deviceOutputCellValues = cl::Buffer();
+        OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceInputCellValues, mDeviceCellBufferCapacity, mOpenCLObject.context);
+        OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceOutputCellValues, mDeviceCellBufferCapacity, mOpenCLObject.context);
+    }
+
+    //kernel only has to be created once, cell buffers are set as its arguments before every generation anyway
+    if (mOpenCLObject.kernelCell() == nullptr)
+    {
+        std::string kernelName = "cell";
+        if (mKernelVariant == OpenCLKernelVariant::localMemory)
+        {
+            kernelName = "cellLocal";
+        }
+        else if (mKernelVariant == OpenCLKernelVariant::bitPacked)
+        {
+            kernelName = "cellPacked";
+        }
+        else if (isLargerThanLifeKernelUsed())
+        {
+            kernelName = (mRule.neighbourhood == LifeNeighbourhood::vonNeumann) ? "cellLargerThanLifeVonNeumann" : "cellLargerThanLife";
+        }
+        mOpenCLObject.kernelCell = OpenCLFunctions::createKernelForProgram(kernelName, mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceColumnStride, mOpenCLObject.deviceTopology, mOpenCLObject.deviceInputCellValues, mOpenCLObject.deviceOutputCellValues});
+        if (isLargerThanLifeKernelUsed())
+        {
+            mOpenCLObject.kernelColumnSums = OpenCLFunctions::createKernelForProgram("livingCellColumnSums", mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceColumnStride, mOpenCLObject.deviceTopology});
+            mOpenCLObject.kernelAreaSums = OpenCLFunctions::createKernelForProgram("livingCellAreaSums", mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceColumnStride, mOpenCLObject.deviceTopology});
+            mOpenCLObject.kernelDiagonalSums = OpenCLFunctions::createKernelForProgram("livingCellDiagonalSums", mOpenCLObject.programCell, {mOpenCLObject.deviceColumnCount, mOpenCLObject.deviceRowCount, mOpenCLObject.deviceColumnStride, mOpenCLObject.deviceTopology});
+            //sum buffers are attached below, since they may have to be reallocated for the new rule's range
+            mDeviceSumBufferCapacity = 0;
+        }
+
+        //local work size only depends on the kernel and the device
+        int bestLocalWorkgroupSizePerDimension = OpenCLFunctions::findBestLocalWorkgroupSizePerDimension(mOpenCLObject.kernelCell, mOpenCLObject.device);
+        mOpenCLObject.localWorkGroupSize = cl::NDRange(bestLocalWorkgroupSizePerDimension, bestLocalWorkgroupSizePerDimension);
+
+        //tile has to hold the whole workgroup plus one cell on every side
+        if (mKernelVariant == OpenCLKernelVariant::localMemory)
+        {
+            OpenCLFunctions::setKernelLocalMemoryArgument(mOpenCLObject.kernelCell, 6, (size_t)(bestLocalWorkgroupSizePerDimension+2)*(bestLocalWorkgroupSizePerDimension+2)*sizeof(uint8_t));
+        }
+    }
+
+    //sums cover the board padded by range cells on every side, summed-area table has one more column of zeros in front,
+    //diagonal sums one more column of zeros on both sides, every buffer is allocated for the largest of them
+    if (isLargerThanLifeKernelUsed())
+    {
+        size_t deviceSumBufferSize = (size_t)(mColumnCount+2*mRule.range+2)*(mRowCount+2*mRule.range+1)*sizeof(int);
+        if (deviceSumBufferSize > mDeviceSumBufferCapacity)
+        {
+            mDeviceSumBufferCapacity = std::max(deviceSumBufferSize, mDeviceSumBufferCapacity*2);
+            mOpenCLObject.deviceColumnSums = cl::Buffer();
+            mOpenCLObject.deviceAreaSums = cl::Buffer();
+            mOpenCLObject.deviceDiagonalSums = cl::Buffer();
+            mOpenCLObject.deviceAntiDiagonalSums = cl::Buffer();
+            OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceColumnSums, mDeviceSumBufferCapacity, mOpenCLObject.context);
+            OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelColumnSums, 5, {mOpenCLObject.deviceColumnSums});
+            if (mRule.neighbourhood == LifeNeighbourhood::moore)
+            {
+                OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceAreaSums, mDeviceSumBufferCapacity, mOpenCLObject.context);
+                OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelAreaSums, 4, {mOpenCLObject.deviceColumnSums, mOpenCLObject.deviceAreaSums});
+                OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelCell, 6, {mOpenCLObject.deviceColumnSums, mOpenCLObject.deviceAreaSums});
+            }
+            else
+            {
+                OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceDiagonalSums, mDeviceSumBufferCapacity, mOpenCLObject.context);
+                OpenCLFunctions::allocateMemoryOnDevice(mOpenCLObject.deviceAntiDiagonalSums, mDeviceSumBufferCapacity, mOpenCLObject.context);
+                OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelDiagonalSums, 4, {mOpenCLObject.deviceColumnSums, mOpenCLObject.deviceDiagonalSums, mOpenCLObject.deviceAntiDiagonalSums});
+                OpenCLFunctions::setKernelArguments(mOpenCLObject.kernelCell, 6, {mOpenCLObject.deviceColumnSums, mOpenCLObject.deviceDiagonalSums, mOpenCLObject.deviceAntiDiagonalSums});
+            }
+        }
+    }
+
+    int arrayFormColumnCount[1] = {mColumnCount};
+    int arrayFormRowCount[1] = {mRowCount};
+    int arrayFormColumnStride[1] = {mColumnStride};
+    OpenCLFunctions::sendDataToDevice((void*)arrayFormColumnCount, mOpenCLObject.deviceColumnCount, 1*sizeof(int), mOpenCLObject.commandQueue);
+    OpenCLFunctions::sendDataToDevice((void*)arrayFormRowCount, mOpenCLObject.deviceRowCount, 1*sizeof(int), mOpenCLObject.commandQueue);
+    OpenCLFunctions::sendDataToDevice((void*)arrayFormColumnStride, mOpenCLObject.deviceColumnStride, 1*sizeof(int), mOpenCLObject.commandQueue);
+
+    //bit-packed kernel only needs one work item per word of every column, von Neumann kernel one per run of rows
+    int localWorkgroupSizePerDimension = (int)mOpenCLObject.localWorkGroupSize[0];
+    int workDimensionY = (mKernelVariant == OpenCLKernelVariant::bitPacked) ? mWordsPerColumn : mRowCount;
+    if (isLargerThanLifeKernelUsed() && mRule.neighbourhood == LifeNeighbourhood::vonNeumann)
+    {
+        workDimensionY = (mRowCount+getVonNeumannRowsPerWorkItem()-1)/getVonNeumannRowsPerWorkItem();
+    }
+    mOpenCLObject.globalWorkGroupSize = OpenCLFunctions::findBestGlobalWorkgroupSize(localWorkgroupSizePerDimension, mColumnCount, workDimensionY);
+}
+
+void OpenCLCellEngine::buildProgramForRule()
+{
+    std::string buildOptions = "-D birthMask="+std::to_string(mRule.birthMask)+" -D survivalMask="+std::to_string(mRule.survivalMask)+" -D stateCount="+std::to_string(mRule.stateCount);
+    if (mRule.hasExtendedNeighbourhood())
+    {
+        buildOptions += " -D extendedNeighbourhood=1 -D neighbourhoodRange="+std::to_string(mRule.range)
+                      + " -D vonNeumannRowsPerWorkItem="+std::to_string(getVonNeumannRowsPerWorkItem())
+                      + " -D birthMinimum="+std::to_string(mRule.birthMinimum)+" -D birthMaximum="+std::to_string(mRule.birthMaximum)
+                      + " -D survivalMinimum="+std::to_string(mRule.survivalMinimum)+" -D survivalMaximum="+std::to_string(mRule.survivalMaximum);
+    }
+    mOpenCLObject.programCell = OpenCLFunctions::buildProgramFromFile(mOpenCLObject.device, mOpenCLObject.context, "Resources/Kernels/cell.txt", buildOptions);
+}
@@ -1,5 +1,32 @@
 #include "../Headers/OpenCLFunctions.h"
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+
+//relative to the working directory, just like Resources
+#define programBinaryCacheDirectory "Cache/Kernels"
+
+bool OpenCLFunctions::isOpenCLAvailable()
+{
+    //unlike other functions below, this one only checks whether OpenCL can be used and never terminates the application
+    std::vector<cl::Platform> allPlatforms;
+    if (cl::Platform::get(&allPlatforms) != CL_SUCCESS || allPlatforms.size()==0)
+    {
+        return false;
+    }
+
+    std::vector<cl::Device> allDevicesOnDefaultPlatform;
+    if (allPlatforms[0].getDevices(CL_DEVICE_TYPE_ALL, &allDevicesOnDefaultPlatform) != CL_SUCCESS || allDevicesOnDefaultPlatform.size()==0)
+    {
+        return false;
+    }
+
+    return true;
+}
+
 std::vector<cl::Platform> OpenCLFunctions::getAllPlatforms()
 {
     std::vector<cl::Platform> allPlatforms;
@@ -50,22 +77,31 @@ std::vector<cl::Device> OpenCLFunctions::getAllDevicesOnAllPlatforms()
     return allDevicesOnAllPlatforms;
 }
 
-cl::Program OpenCLFunctions::buildProgramFromFile(cl::Device& device, cl::Context& context, const std::string& programFilepath)
+cl::Program OpenCLFunctions::buildProgramFromFile(cl::Device& device, cl::Context& context, const std::string& programFilepath, const std::string& buildOptions)
 {
     cl::Program::Sources sources;
 
     std::ifstream file(programFilepath);
     std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
+    //compiling from source takes seconds on CPU runtimes, so cached binary is used whenever it matches everything the compiler depends on
+    std::string programCacheKey = getProgramCacheKey(device, content, buildOptions);
+    cl::Program cachedProgram;
+    if (loadProgramFromCache(device, context, programCacheKey, buildOptions, cachedProgram))
+    {
+        return cachedProgram;
+    }
+
     sources.push_back({content.c_str(), content.length()});
 
     cl::Program program(context, sources);
-    if (program.build({device}) != CL_SUCCESS)
+    if (program.build({device}, buildOptions.c_str()) != CL_SUCCESS)
     {
         std::cout << "Error building: " << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device) << std::endl;
         exit(1);
     }
 
+    saveProgramToCache(program, programCacheKey);
     return program;
 }
 
@@ -90,17 +126,32 @@ cl::Kernel OpenCLFunctions::createKernelForProgram(const std::string& kernelName
         exit(1);
     }
 
+    setKernelArguments(kernel, 0, arguments);
+
+    return kernel;
+}
+
+void OpenCLFunctions::setKernelArguments(cl::Kernel& kernel, int firstArgumentIndex, std::vector<cl::Buffer> arguments)
+{
     for (int i=0; i<arguments.size(); i++)
     {
-        error = kernel.setArg(i, arguments[i]);
+        int error = kernel.setArg(firstArgumentIndex+i, arguments[i]);
         if(error < 0)
         {
             std::cout << "OpenCL Kernel argument setting failed with error code: " << error << std::endl;
             exit(1);
         }
     }
+}
 
-    return kernel;
+void OpenCLFunctions::setKernelLocalMemoryArgument(cl::Kernel& kernel, int argumentIndex, size_t localMemorySize)
+{
+    int error = kernel.setArg(argumentIndex, cl::Local(localMemorySize));
+    if(error < 0)
+    {
+        std::cout << "OpenCL Kernel local memory argument setting failed with error code: " << error << std::endl;
+        exit(1);
+    }
 }
 
 void OpenCLFunctions::sendDataToDevice(void* hostData, cl::Buffer deviceData, size_t dataArraySize, cl::CommandQueue& commandQueue)
@@ -151,4 +202,111 @@ void OpenCLFunctions::startKernel(cl::Kernel& kernel, cl::CommandQueue& commandQ
         std::cout << "Couldn't enqueue the kernel, error code: " << err << std::endl;
         exit(1);
     }
-}
\ No newline at end of file
+}
+
+std::string OpenCLFunctions::getProgramCacheKey(cl::Device& device, const std::string& programSource, const std::string& buildOptions)
+{
+    //source itself is only stored as its FNV-1a hash, every other part is kept as it is and compared when loading,
+    //so a collision of file names can never load a wrong binary
+    uint64_t sourceHash = 14695981039346656037ull;
+    for (char character : programSource)
+    {
+        sourceHash = (sourceHash ^ (unsigned char)character)*1099511628211ull;
+    }
+
+    std::ostringstream programCacheKey;
+    programCacheKey << "device: " << device.getInfo<CL_DEVICE_NAME>() << "\n"
+                    << "device version: " << device.getInfo<CL_DEVICE_VERSION>() << "\n"
+                    << "driver version: " << device.getInfo<CL_DRIVER_VERSION>() << "\n"
+                    << "build options: " << buildOptions << "\n"
+                    << "source hash: " << std::hex << sourceHash << "\n";
+    return programCacheKey.str();
+}
+
+std::string OpenCLFunctions::getProgramCacheFilepath(const std::string& programCacheKey)
+{
+    uint64_t keyHash = 14695981039346656037ull;
+    for (char character : programCacheKey)
+    {
+        keyHash = (keyHash ^ (unsigned char)character)*1099511628211ull;
+    }
+
+    std::ostringstream programCacheFilepath;
+    programCacheFilepath << programBinaryCacheDirectory << "/" << std::hex << keyHash << ".bin";
+    return programCacheFilepath.str();
+}
+
+bool OpenCLFunctions::loadProgramFromCache(cl::Device& device, cl::Context& context, const std::string& programCacheKey, const std::string& buildOptions, cl::Program& program)
+{
+    //file holds the key terminated by a null character followed by the binary
+    std::ifstream file(getProgramCacheFilepath(programCacheKey), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content.size() <= programCacheKey.size()+1 || content.compare(0, programCacheKey.size(), programCacheKey) != 0 || content[programCacheKey.size()] != '\0')
+    {
+        return false;
+    }
+
+    //binaries still have to be built, but that only links them, drivers reject binaries they cannot use, so those are simply compiled again
+    const char* binary = content.data()+programCacheKey.size()+1;
+    cl::Program::Binaries binaries = {{binary, content.size()-programCacheKey.size()-1}};
+    cl_int error = CL_SUCCESS;
+    program = cl::Program(context, {device}, binaries, nullptr, &error);
+    if (error != CL_SUCCESS)
+    {
+        return false;
+    }
+    return program.build({device}, buildOptions.c_str()) == CL_SUCCESS;
+}
+
+void OpenCLFunctions::saveProgramToCache(cl::Program& program, const std::string& programCacheKey)
+{
+    //program is built for a single device, so it has exactly one binary
+    std::vector<size_t> binarySizes = program.getInfo<CL_PROGRAM_BINARY_SIZES>();
+    if (binarySizes.size() != 1 || binarySizes[0] == 0)
+    {
+        return;
+    }
+    std::vector<char> binary(binarySizes[0]);
+    char* binaryData = binary.data();
+    if (clGetProgramInfo(program(), CL_PROGRAM_BINARIES, sizeof(char*), &binaryData, nullptr) != CL_SUCCESS)
+    {
+        return;
+    }
+
+    //binary is written under a temporary name first, so another instance never loads a half written file, the name gets a random suffix,
+    //so instances saving the same program at the same time never write into one file, the last rename simply wins,
+    //failing to cache it only costs compiling it again on the next launch
+    std::error_code error;
+    std::filesystem::create_directories(programBinaryCacheDirectory, error);
+    std::string programCacheFilepath = getProgramCacheFilepath(programCacheKey);
+    thread_local std::mt19937_64 randomGenerator([]()
+    {
+        //entropy source is only opened once per thread, to seed the generator
+        std::random_device randomDevice;
+        return ((uint64_t)randomDevice() << 32) ^ randomDevice() ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    }());
+    std::ostringstream temporaryFilepathStream;
+    temporaryFilepathStream << programCacheFilepath << "." << std::hex << randomGenerator() << ".tmp";
+    std::string temporaryFilepath = temporaryFilepathStream.str();
+    {
+        std::ofstream file(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        file.write(programCacheKey.c_str(), (std::streamsize)programCacheKey.size()+1);
+        file.write(binary.data(), (std::streamsize)binary.size());
+        if (!file)
+        {
+            std::cout << "Could not write OpenCL program cache file " << temporaryFilepath << std::endl;
+            file.close();
+            std::filesystem::remove(temporaryFilepath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporaryFilepath, programCacheFilepath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryFilepath, error);
+    }
+}
@@ -0,0 +1,513 @@
+#include "../Headers/PatternFile.h"
+#include "../Headers/MacrocellFile.h"
+
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+//lines of run length encoded files are kept this short, as the format expects
+#define runLengthEncodedLineLength 70
+//run length encoded files go row by row, while the grid is column-major, so rows are gathered in blocks this high and transposed at once
+#define rowBlockHeight 64
+//headers may claim any size up to 2^30 in both directions, larger boards are refused before anything is allocated, same as for macrocells
+#define maximumCellCount ((int64_t)1 << 32)
+
+namespace
+{
+    void skipSpaces(const std::string& content, size_t& position)
+    {
+        while (position < content.size() && (content[position] == ' ' || content[position] == '\t'))
+        {
+            position++;
+        }
+    }
+
+    void skipLine(const std::string& content, size_t& position)
+    {
+        while (position < content.size() && content[position] != '\n')
+        {
+            position++;
+        }
+        if (position < content.size())
+        {
+            position++;
+        }
+    }
+
+    //parses "name = value" of the header line, returns false if there is anything else at the position
+    bool parseHeaderNumber(const std::string& content, size_t& position, char name, int& number)
+    {
+        skipSpaces(content, position);
+        if (position >= content.size() || content[position] != name)
+        {
+            return false;
+        }
+        position++;
+        skipSpaces(content, position);
+        if (position >= content.size() || content[position] != '=')
+        {
+            return false;
+        }
+        position++;
+        skipSpaces(content, position);
+        long long value = 0;
+        size_t firstDigit = position;
+        while (position < content.size() && std::isdigit((unsigned char)content[position]) && value <= 1 << 30)
+        {
+            value = value*10+(content[position++]-'0');
+        }
+        number = (int)value;
+        return position > firstDigit && value <= 1 << 30;
+    }
+
+    //refuses boards over maximumCellCount cells and boards the memory cannot hold, instead of letting the allocation terminate the application
+    bool resizeCellGrid(CellGrid& cellGrid, int columnCount, int rowCount, const char* formatName)
+    {
+        if ((int64_t)columnCount*rowCount > maximumCellCount)
+        {
+            std::cout << "Board of " << columnCount << "x" << rowCount << " cells of " << formatName << " pattern is too large" << std::endl;
+            return false;
+        }
+        try
+        {
+            cellGrid.resize(columnCount, rowCount);
+        }
+        catch (const std::bad_alloc&)
+        {
+            std::cout << "Not enough memory for a board of " << columnCount << "x" << rowCount << " cells of " << formatName << " pattern" << std::endl;
+            return false;
+        }
+        cellGrid.clear();
+        return true;
+    }
+
+    //rows from firstRow on are stored one after another in the block, every row holds all columns of the grid
+    void copyRowBlockToGrid(const std::vector<uint8_t>& rowBlock, CellGrid& cellGrid, int firstRow)
+    {
+        int rowCount = std::min(rowBlockHeight, cellGrid.getRowCount()-firstRow);
+        for (int column=0; column<cellGrid.getColumnCount(); column++)
+        {
+            uint8_t* cellValues = cellGrid.getData()+(size_t)column*cellGrid.getColumnStride()+firstRow;
+            for (int i=0; i<rowCount; i++)
+            {
+                cellValues[i] = rowBlock[(size_t)i*cellGrid.getColumnCount()+column];
+            }
+        }
+    }
+
+    void copyGridToRowBlock(const CellGrid& cellGrid, int firstRow, std::vector<uint8_t>& rowBlock)
+    {
+        int rowCount = std::min(rowBlockHeight, cellGrid.getRowCount()-firstRow);
+        for (int column=0; column<cellGrid.getColumnCount(); column++)
+        {
+            const uint8_t* cellValues = cellGrid.getData()+(size_t)column*cellGrid.getColumnStride()+firstRow;
+            for (int i=0; i<rowCount; i++)
+            {
+                rowBlock[(size_t)i*cellGrid.getColumnCount()+column] = cellValues[i];
+            }
+        }
+    }
+
+    //end of the run of equal cells starting at the column, compares 8 cells at once, so a row of random cells costs about one branch per run
+    int findRunEnd(const uint8_t* cellValues, int column, int columnCount)
+    {
+        uint64_t runWord = 0x0101010101010101ull*cellValues[column];
+        int runEnd = column+1;
+        for (; runEnd+8 <= columnCount; runEnd+=8)
+        {
+            uint64_t word;
+            std::memcpy(&word, cellValues+runEnd, sizeof(word));
+            if (word != runWord)
+            {
+                //first differing byte is the lowest one in memory
+                uint64_t difference = word ^ runWord;
+                return runEnd+(std::endian::native == std::endian::little ? std::countr_zero(difference) : std::countl_zero(difference))/8;
+            }
+        }
+        while (runEnd < columnCount && cellValues[runEnd] == cellValues[column])
+        {
+            runEnd++;
+        }
+        return runEnd;
+    }
+
+    //Generations states are written as 'A' (living) to 'X', states above 24 get a prefix from 'p' to 'y', so "pA" is 25,
+    //returns the end of the written characters
+    char* writeCellState(char* token, int cellValue, int stateCount)
+    {
+        if (stateCount == 2)
+        {
+            *token++ = cellValue ? 'o' : 'b';
+        }
+        else if (cellValue == 0)
+        {
+            *token++ = '.';
+        }
+        else
+        {
+            if (cellValue > 24)
+            {
+                *token++ = (char)('p'+(cellValue-25)/24);
+            }
+            *token++ = (char)('A'+(cellValue-1)%24);
+        }
+        return token;
+    }
+}
+
+bool PatternFile::load(const std::string& filepath, CellGrid& cellGrid, LifeRule& rule)
+{
+    if (MacrocellFile::isMacrocell(filepath))
+    {
+        return MacrocellFile::load(filepath, cellGrid, rule);
+    }
+
+    std::string content;
+    if (!readWholeFile(filepath, content))
+    {
+        std::cout << "Cannot open pattern file " << filepath << std::endl;
+        return false;
+    }
+
+    bool isLoaded = isRunLengthEncoded(filepath) ? parseRunLengthEncoded(content, cellGrid, rule) : parsePlaintext(content, cellGrid);
+    if (!isLoaded)
+    {
+        std::cout << "Cannot load pattern file " << filepath << std::endl;
+    }
+    return isLoaded;
+}
+
+bool PatternFile::save(const std::string& filepath, const CellGrid& cellGrid, const LifeRule& rule)
+{
+    //quadtree is built by the HashLife engine, so only patterns of two cell states can be saved this way
+    if (MacrocellFile::isMacrocell(filepath))
+    {
+        if (rule.isGenerations())
+        {
+            std::cout << "Boards of Generations rules cannot be saved as macrocell files" << std::endl;
+            return false;
+        }
+        HashLifeEngine hashLifeEngine;
+        hashLifeEngine.setCells(cellGrid);
+        return MacrocellFile::save(filepath, hashLifeEngine, rule);
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Cannot create pattern file " << filepath << std::endl;
+        return false;
+    }
+
+    //whole file is composed in memory and written at once, which is far faster than writing it token by token
+    file << (isRunLengthEncoded(filepath) ? writeRunLengthEncoded(cellGrid, rule) : writePlaintext(cellGrid));
+    return file.good();
+}
+
+bool PatternFile::isRunLengthEncoded(const std::string& filepath)
+{
+    std::string extension = filepath.size() >= 4 ? filepath.substr(filepath.size()-4) : "";
+    for (char& character : extension)
+    {
+        character = (char)std::tolower((unsigned char)character);
+    }
+    return extension == ".rle";
+}
+
+bool PatternFile::readWholeFile(const std::string& filepath, std::string& content)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    content.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read(content.data(), (std::streamsize)content.size());
+    return file.good() || file.eof();
+}
+
+bool PatternFile::parsePlaintext(const std::string& content, CellGrid& cellGrid)
+{
+    //first pass only measures the pattern, trailing dead cells are commonly left out, so the widest row decides its width
+    int columnCount = 0, rowCount = 0;
+    for (size_t position = 0; position < content.size();)
+    {
+        size_t lineEnd = std::min(content.find('\n', position), content.size());
+        size_t lineLength = lineEnd-position;
+        if (lineLength > 0 && content[lineEnd-1] == '\r')
+        {
+            lineLength--;
+        }
+        if (content[position] != '!')
+        {
+            columnCount = std::max(columnCount, (int)lineLength);
+            rowCount++;
+        }
+        position = lineEnd+1;
+    }
+
+    if (!resizeCellGrid(cellGrid, columnCount, rowCount, "plaintext"))
+    {
+        return false;
+    }
+    int row = 0;
+    for (size_t position = 0; position < content.size();)
+    {
+        size_t lineEnd = std::min(content.find('\n', position), content.size());
+        if (content[position] != '!')
+        {
+            for (int column=0; position+column < lineEnd && content[position+column] != '\r'; column++)
+            {
+                char cell = content[position+column];
+                if (cell == 'O' || cell == '*')
+                {
+                    cellGrid.setCellValue(column, row, 1);
+                }
+                else if (cell != '.')
+                {
+                    std::cout << "Unexpected character '" << cell << "' on row " << row+1 << " of plaintext pattern" << std::endl;
+                    return false;
+                }
+            }
+            row++;
+        }
+        position = lineEnd+1;
+    }
+    return true;
+}
+
+bool PatternFile::parseRunLengthEncoded(const std::string& content, CellGrid& cellGrid, LifeRule& rule)
+{
+    //comment lines come before the header, "#r" lines of older files name the rule
+    size_t position = 0;
+    std::string ruleString;
+    while (position < content.size() && (content[position] == '#' || content[position] == '\r' || content[position] == '\n'))
+    {
+        if (content.compare(position, 2, "#r") == 0)
+        {
+            size_t lineEnd = std::min(content.find('\n', position), content.size());
+            ruleString = content.substr(position+2, lineEnd-position-2);
+        }
+        skipLine(content, position);
+    }
+
+    //header is "x = 3, y = 3, rule = B3/S23", the rule is the rest of the line since Larger than Life rules contain commas
+    int columnCount = 0, rowCount = 0;
+    if (!parseHeaderNumber(content, position, 'x', columnCount))
+    {
+        std::cout << "Run length encoded pattern has no valid \"x = columns, y = rows\" header" << std::endl;
+        return false;
+    }
+    skipSpaces(content, position);
+    if (position >= content.size() || content[position++] != ',' || !parseHeaderNumber(content, position, 'y', rowCount))
+    {
+        std::cout << "Run length encoded pattern has no valid \"x = columns, y = rows\" header" << std::endl;
+        return false;
+    }
+    size_t headerEnd = std::min(content.find('\n', position), content.size());
+    std::string headerRest = content.substr(position, headerEnd-position);
+    size_t ruleKey = headerRest.find("rule");
+    if (ruleKey != std::string::npos)
+    {
+        size_t ruleValue = headerRest.find('=', ruleKey);
+        ruleString = ruleValue != std::string::npos ? headerRest.substr(ruleValue+1) : "";
+    }
+    position = headerEnd;
+
+    //spaces and the bounded grid suffix (such as ":T100,100") are not a part of the rule itself
+    ruleString = ruleString.substr(0, ruleString.find(':'));
+    std::erase_if(ruleString, [](char character) { return std::isspace((unsigned char)character); });
+    if (!ruleString.empty())
+    {
+        LifeRule fileRule;
+        if (LifeRule::parse(ruleString, fileRule))
+        {
+            rule = fileRule;
+        }
+        else
+        {
+            std::cout << "Rule " << ruleString << " of the pattern is not supported, keeping rule " << rule.toString() << std::endl;
+        }
+    }
+
+    //runs are written into a block of rows in a single pass, cells outside the size given by the header are dropped
+    if (!resizeCellGrid(cellGrid, std::max(columnCount, 1), std::max(rowCount, 1), "run length encoded"))
+    {
+        return false;
+    }
+    std::vector<uint8_t> rowBlock;
+    try
+    {
+        rowBlock.assign((size_t)cellGrid.getColumnCount()*rowBlockHeight, 0);
+    }
+    catch (const std::bad_alloc&)
+    {
+        std::cout << "Not enough memory for rows of " << cellGrid.getColumnCount() << " cells of run length encoded pattern" << std::endl;
+        return false;
+    }
+    int rowBlockFirstRow = 0;
+    int column = 0, row = 0;
+    long long runCount = 0;
+    int statePrefix = 0;
+    for (; position < content.size(); position++)
+    {
+        char character = content[position];
+        if (character >= '0' && character <= '9')
+        {
+            runCount = std::min(runCount*10+(character-'0'), 1LL << 31);
+            continue;
+        }
+        if (character == '\n' || character == '\r' || character == ' ' || character == '\t')
+        {
+            continue;
+        }
+        if (character == '!')
+        {
+            break;
+        }
+
+        int length = runCount > 0 ? (int)std::min(runCount, (long long)INT32_MAX) : 1;
+        runCount = 0;
+        int cellValue;
+        if (character == '$')
+        {
+            row += std::min(length, INT32_MAX-row);
+            column = 0;
+            //blocks skipped over are empty, and the grid is already clear
+            if (row >= rowBlockFirstRow+rowBlockHeight && rowBlockFirstRow < cellGrid.getRowCount())
+            {
+                copyRowBlockToGrid(rowBlock, cellGrid, rowBlockFirstRow);
+                std::fill(rowBlock.begin(), rowBlock.end(), 0);
+                rowBlockFirstRow = row-row%rowBlockHeight;
+            }
+            continue;
+        }
+        else if (character >= 'p' && character <= 'y' && statePrefix == 0)
+        {
+            statePrefix = character-'p'+1;
+            runCount = length > 1 ? length : 0;
+            continue;
+        }
+        else if (character >= 'A' && character <= 'X')
+        {
+            cellValue = statePrefix*24+character-'A'+1;
+        }
+        else if (character == 'b' || character == '.')
+        {
+            cellValue = 0;
+        }
+        else if (std::islower((unsigned char)character) && statePrefix == 0)
+        {
+            //two-state files may use any other letter for living cells, 'o' is the usual one
+            cellValue = 1;
+        }
+        else
+        {
+            std::cout << "Unexpected character '" << character << "' on row " << row+1 << " of run length encoded pattern" << std::endl;
+            return false;
+        }
+        statePrefix = 0;
+
+        if (cellValue >= rule.stateCount)
+        {
+            std::cout << "Cell state " << cellValue << " on row " << row+1 << " of run length encoded pattern does not exist in rule " << rule.toString() << std::endl;
+            return false;
+        }
+        if (cellValue != 0 && row < cellGrid.getRowCount() && column < cellGrid.getColumnCount())
+        {
+            int runLength = (int)std::min((long long)length, (long long)cellGrid.getColumnCount()-column);
+            std::fill_n(&rowBlock[(size_t)(row-rowBlockFirstRow)*cellGrid.getColumnCount()+column], runLength, (uint8_t)cellValue);
+        }
+        column += std::min(length, INT32_MAX-column);
+    }
+    if (rowBlockFirstRow < cellGrid.getRowCount())
+    {
+        copyRowBlockToGrid(rowBlock, cellGrid, rowBlockFirstRow);
+    }
+    return true;
+}
+
+std::string PatternFile::writePlaintext(const CellGrid& cellGrid)
+{
+    std::string content;
+    content.reserve(((size_t)cellGrid.getColumnCount()+1)*cellGrid.getRowCount());
+    for (int row=0; row<cellGrid.getRowCount(); row++)
+    {
+        for (int column=0; column<cellGrid.getColumnCount(); column++)
+        {
+            content += cellGrid.getCellValue(column, row) == 1 ? 'O' : '.';
+        }
+        content += '\n';
+    }
+    return content;
+}
+
+std::string PatternFile::writeRunLengthEncoded(const CellGrid& cellGrid, const LifeRule& rule)
+{
+    std::string content = "x = "+std::to_string(cellGrid.getColumnCount())+", y = "+std::to_string(cellGrid.getRowCount())+", rule = "+rule.toString()+"\n";
+    size_t lineBegin = content.size();
+    char token[16];
+    auto appendToken = [&](int length, int cellValue, char character)
+    {
+        char* tokenEnd = token;
+        if (length > 1)
+        {
+            tokenEnd = std::to_chars(token, token+sizeof(token), length).ptr;
+        }
+        if (character != 0)
+        {
+            *tokenEnd++ = character;
+        }
+        else
+        {
+            tokenEnd = writeCellState(tokenEnd, cellValue, rule.stateCount);
+        }
+        //tokens are never split between lines
+        if (content.size()-lineBegin+(tokenEnd-token) > runLengthEncodedLineLength)
+        {
+            content += '\n';
+            lineBegin = content.size();
+        }
+        content.append(token, tokenEnd);
+    };
+
+    //dead cells at the end of a row are left out and empty rows are merged into a single "n$"
+    std::vector<uint8_t> rowBlock((size_t)cellGrid.getColumnCount()*rowBlockHeight);
+    int pendingRowEndCount = 0;
+    for (int row=0; row<cellGrid.getRowCount(); row++)
+    {
+        if (row%rowBlockHeight == 0)
+        {
+            copyGridToRowBlock(cellGrid, row, rowBlock);
+        }
+        const uint8_t* cellValues = &rowBlock[(size_t)(row%rowBlockHeight)*cellGrid.getColumnCount()];
+        int column = 0;
+        while (column < cellGrid.getColumnCount())
+        {
+            int cellValue = cellValues[column];
+            int runEnd = findRunEnd(cellValues, column, cellGrid.getColumnCount());
+            if (cellValue == 0 && runEnd == cellGrid.getColumnCount())
+            {
+                break;
+            }
+            if (pendingRowEndCount > 0)
+            {
+                appendToken(pendingRowEndCount, 0, '$');
+                pendingRowEndCount = 0;
+            }
+            appendToken(runEnd-column, cellValue, 0);
+            column = runEnd;
+        }
+        pendingRowEndCount++;
+    }
+    appendToken(1, 0, '!');
+    content += '\n';
+    return content;
+}
@@ -0,0 +1,407 @@
+#include "../Headers/SimdCellEngine.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GAMEOFLIFE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    template<typename Rule>
+    inline uint8_t calculateCell(const uint8_t* cell, int columnStride, const LifeRule& rule)
+    {
+        //only living cells count as neighbours, dying cells of Generations rules do not
+        int livingNeighboursCount = (cell[-columnStride-1] == 1) + (cell[-columnStride] == 1) + (cell[-columnStride+1] == 1)
+                                  + (cell[-1] == 1) + (cell[1] == 1)
+                                  + (cell[columnStride-1] == 1) + (cell[columnStride] == 1) + (cell[columnStride+1] == 1);
+        if (cell[0] == 0)
+        {
+            return (Rule::getBirthMask(rule) >> livingNeighboursCount) & 1;
+        }
+        if (cell[0] == 1 && ((Rule::getSurvivalMask(rule) >> livingNeighboursCount) & 1))
+        {
+            return 1;
+        }
+        return (cell[0]+1 < Rule::getStateCount(rule)) ? cell[0]+1 : 0;
+    }
+
+    template<typename Rule>
+    void calculateColumnsScalar(const uint8_t* inputCellValues, uint8_t* outputCellValues, int columnCount, int rowCount, int columnStride, const LifeRule& rule)
+    {
+        for (int i=1; i<=columnCount; i++)
+        {
+            for (int j=1; j<=rowCount; j++)
+            {
+                outputCellValues[(size_t)i*columnStride+j] = calculateCell<Rule>(&inputCellValues[(size_t)i*columnStride+j], columnStride, rule);
+            }
+        }
+    }
+
+#ifdef GAMEOFLIFE_X86_SIMD
+    //cells of Life-like rules are either 0 or 1, so they are summed as they are, Generations rules first turn dying cells into zeros
+    template<typename Rule>
+    inline __m128i loadLivingCellsSse2(const uint8_t* cells, const LifeRule& rule)
+    {
+        __m128i cellValues = _mm_loadu_si128((const __m128i*)cells);
+        if (Rule::getStateCount(rule) == 2)
+        {
+            return cellValues;
+        }
+        return _mm_and_si128(_mm_cmpeq_epi8(cellValues, _mm_set1_epi8(1)), _mm_set1_epi8(1));
+    }
+
+    //every vector holds consecutive rows of one column, one byte per cell, so neighbours from rows above and below are just unaligned loads shifted by one cell,
+    //only neighbour counts used by the rule are compared, for static rules those loops unroll into exactly the comparisons the rule needs
+    template<typename Rule>
+    void calculateColumnsSse2(const uint8_t* inputCellValues, uint8_t* outputCellValues, int columnCount, int rowCount, int columnStride, const LifeRule& rule)
+    {
+        const __m128i zeros = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi8(1);
+        const __m128i stateCounts = _mm_set1_epi8((char)Rule::getStateCount(rule));
+        for (int i=1; i<=columnCount; i++)
+        {
+            const uint8_t* left = &inputCellValues[(size_t)(i-1)*columnStride];
+            const uint8_t* center = &inputCellValues[(size_t)i*columnStride];
+            const uint8_t* right = &inputCellValues[(size_t)(i+1)*columnStride];
+            uint8_t* output = &outputCellValues[(size_t)i*columnStride];
+
+            int j = 1;
+            for (; j+15<=rowCount; j+=16)
+            {
+                __m128i leftSum = _mm_add_epi8(_mm_add_epi8(loadLivingCellsSse2<Rule>(&left[j-1], rule), loadLivingCellsSse2<Rule>(&left[j], rule)), loadLivingCellsSse2<Rule>(&left[j+1], rule));
+                __m128i centerSum = _mm_add_epi8(loadLivingCellsSse2<Rule>(&center[j-1], rule), loadLivingCellsSse2<Rule>(&center[j+1], rule));
+                __m128i rightSum = _mm_add_epi8(_mm_add_epi8(loadLivingCellsSse2<Rule>(&right[j-1], rule), loadLivingCellsSse2<Rule>(&right[j], rule)), loadLivingCellsSse2<Rule>(&right[j+1], rule));
+                __m128i livingNeighboursCount = _mm_add_epi8(_mm_add_epi8(leftSum, centerSum), rightSum);
+
+                __m128i cell = _mm_loadu_si128((const __m128i*)&center[j]);
+                __m128i nextGeneration = _mm_setzero_si128();
+                if (Rule::getStateCount(rule) == 2)
+                {
+                    for (int k=0; k<=8; k++)
+                    {
+                        bool isBirth = (Rule::getBirthMask(rule) >> k) & 1;
+                        bool isSurvival = (Rule::getSurvivalMask(rule) >> k) & 1;
+                        if (isBirth || isSurvival)
+                        {
+                            __m128i nextCell = isBirth ? (isSurvival ? ones : _mm_andnot_si128(cell, ones)) : cell;
+                            nextGeneration = _mm_or_si128(nextGeneration, _mm_and_si128(_mm_cmpeq_epi8(livingNeighboursCount, _mm_set1_epi8((char)k)), nextCell));
+                        }
+                    }
+                }
+                else
+                {
+                    //dead cells may be born and living ones may survive, every other cell moves on to the next state, wrapping to dead after the last one
+                    __m128i isBirthCount = _mm_setzero_si128();
+                    __m128i isSurvivalCount = _mm_setzero_si128();
+                    for (int k=0; k<=8; k++)
+                    {
+                        if ((Rule::getBirthMask(rule) >> k) & 1)
+                        {
+                            isBirthCount = _mm_or_si128(isBirthCount, _mm_cmpeq_epi8(livingNeighboursCount, _mm_set1_epi8((char)k)));
+                        }
+                        if ((Rule::getSurvivalMask(rule) >> k) & 1)
+                        {
+                            isSurvivalCount = _mm_or_si128(isSurvivalCount, _mm_cmpeq_epi8(livingNeighboursCount, _mm_set1_epi8((char)k)));
+                        }
+                    }
+                    __m128i isDead = _mm_cmpeq_epi8(cell, zeros);
+                    __m128i isBorn = _mm_and_si128(isDead, isBirthCount);
+                    __m128i isSurviving = _mm_and_si128(_mm_cmpeq_epi8(cell, ones), isSurvivalCount);
+                    __m128i agedCell = _mm_add_epi8(cell, ones);
+                    agedCell = _mm_andnot_si128(_mm_or_si128(_mm_or_si128(isDead, isSurviving), _mm_cmpeq_epi8(agedCell, stateCounts)), agedCell);
+                    nextGeneration = _mm_or_si128(agedCell, _mm_and_si128(_mm_or_si128(isBorn, isSurviving), ones));
+                }
+                _mm_storeu_si128((__m128i*)&output[j], nextGeneration);
+            }
+            for (; j<=rowCount; j++)
+            {
+                output[j] = calculateCell<Rule>(&center[j], columnStride, rule);
+            }
+        }
+    }
+
+    template<typename Rule>
+    __attribute__((target("avx2")))
+    inline __m256i loadLivingCellsAvx2(const uint8_t* cells, const LifeRule& rule)
+    {
+        __m256i cellValues = _mm256_loadu_si256((const __m256i*)cells);
+        if (Rule::getStateCount(rule) == 2)
+        {
+            return cellValues;
+        }
+        return _mm256_and_si256(_mm256_cmpeq_epi8(cellValues, _mm256_set1_epi8(1)), _mm256_set1_epi8(1));
+    }
+
+    template<typename Rule>
+    __attribute__((target("avx2")))
+    void calculateColumnsAvx2(const uint8_t* inputCellValues, uint8_t* outputCellValues, int columnCount, int rowCount, int columnStride, const LifeRule& rule)
+    {
+        const __m256i zeros = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi8(1);
+        const __m256i stateCounts = _mm256_set1_epi8((char)Rule::getStateCount(rule));
+        for (int i=1; i<=columnCount; i++)
+        {
+            const uint8_t* left = &inputCellValues[(size_t)(i-1)*columnStride];
+            const uint8_t* center = &inputCellValues[(size_t)i*columnStride];
+            const uint8_t* right = &inputCellValues[(size_t)(i+1)*columnStride];
+            uint8_t* output = &outputCellValues[(size_t)i*columnStride];
+
+            int j = 1;
+            for (; j+31<=rowCount; j+=32)
+            {
+                __m256i leftSum = _mm256_add_epi8(_mm256_add_epi8(loadLivingCellsAvx2<Rule>(&left[j-1], rule), loadLivingCellsAvx2<Rule>(&left[j], rule)), loadLivingCellsAvx2<Rule>(&left[j+1], rule));
+                __m256i centerSum = _mm256_add_epi8(loadLivingCellsAvx2<Rule>(&center[j-1], rule), loadLivingCellsAvx2<Rule>(&center[j+1], rule));
+                __m256i rightSum = _mm256_add_epi8(_mm256_add_epi8(loadLivingCellsAvx2<Rule>(&right[j-1], rule), loadLivingCellsAvx2<Rule>(&right[j], rule)), loadLivingCellsAvx2<Rule>(&right[j+1], rule));
+                __m256i livingNeighboursCount = _mm256_add_epi8(_mm256_add_epi8(leftSum, centerSum), rightSum);
+
+                __m256i cell = _mm256_loadu_si256((const __m256i*)&center[j]);
+                __m256i nextGeneration = _mm256_setzero_si256();
+                if (Rule::getStateCount(rule) == 2)
+                {
+                    for (int k=0; k<=8; k++)
+                    {
+                        bool isBirth = (Rule::getBirthMask(rule) >> k) & 1;
+                        bool isSurvival = (Rule::getSurvivalMask(rule) >> k) & 1;
+                        if (isBirth || isSurvival)
+                        {
+                            __m256i nextCell = isBirth ? (isSurvival ? ones : _mm256_andnot_si256(cell, ones)) : cell;
+                            nextGeneration = _mm256_or_si256(nextGeneration, _mm256_and_si256(_mm256_cmpeq_epi8(livingNeighboursCount, _mm256_set1_epi8((char)k)), nextCell));
+                        }
+                    }
+                }
+                else
+                {
+                    __m256i isBirthCount = _mm256_setzero_si256();
+                    __m256i isSurvivalCount = _mm256_setzero_si256();
+                    for (int k=0; k<=8; k++)
+                    {
+                        if ((Rule::getBirthMask(rule) >> k) & 1)
+                        {
+                            isBirthCount = _mm256_or_si256(isBirthCount, _mm256_cmpeq_epi8(livingNeighboursCount, _mm256_set1_epi8((char)k)));
+                        }
+                        if ((Rule::getSurvivalMask(rule) >> k) & 1)
+                        {
+                            isSurvivalCount = _mm256_or_si256(isSurvivalCount, _mm256_cmpeq_epi8(livingNeighboursCount, _mm256_set1_epi8((char)k)));
+                        }
+                    }
+                    __m256i isDead = _mm256_cmpeq_epi8(cell, zeros);
+                    __m256i isBorn = _mm256_and_si256(isDead, isBirthCount);
+                    __m256i isSurviving = _mm256_and_si256(_mm256_cmpeq_epi8(cell, ones), isSurvivalCount);
+                    __m256i agedCell = _mm256_add_epi8(cell, ones);
+                    agedCell = _mm256_andnot_si256(_mm256_or_si256(_mm256_or_si256(isDead, isSurviving), _mm256_cmpeq_epi8(agedCell, stateCounts)), agedCell);
+                    nextGeneration = _mm256_or_si256(agedCell, _mm256_and_si256(_mm256_or_si256(isBorn, isSurviving), ones));
+                }
+                _mm256_storeu_si256((__m256i*)&output[j], nextGeneration);
+            }
+            for (; j<=rowCount; j++)
+            {
+                output[j] = calculateCell<Rule>(&center[j], columnStride, rule);
+            }
+        }
+    }
+
+    //byte lanes of AVX-512 need its BW extension
+    template<typename Rule>
+    __attribute__((target("avx512f,avx512bw")))
+    inline __m512i loadLivingCellsAvx512(const uint8_t* cells, const LifeRule& rule)
+    {
+        __m512i cellValues = _mm512_loadu_si512(cells);
+        if (Rule::getStateCount(rule) == 2)
+        {
+            return cellValues;
+        }
+        return _mm512_maskz_mov_epi8(_mm512_cmpeq_epi8_mask(cellValues, _mm512_set1_epi8(1)), _mm512_set1_epi8(1));
+    }
+
+    template<typename Rule>
+    __attribute__((target("avx512f,avx512bw")))
+    void calculateColumnsAvx512(const uint8_t* inputCellValues, uint8_t* outputCellValues, int columnCount, int rowCount, int columnStride, const LifeRule& rule)
+    {
+        const __m512i ones = _mm512_set1_epi8(1);
+        const __m512i stateCounts = _mm512_set1_epi8((char)Rule::getStateCount(rule));
+        for (int i=1; i<=columnCount; i++)
+        {
+            const uint8_t* left = &inputCellValues[(size_t)(i-1)*columnStride];
+            const uint8_t* center = &inputCellValues[(size_t)i*columnStride];
+            const uint8_t* right = &inputCellValues[(size_t)(i+1)*columnStride];
+            uint8_t* output = &outputCellValues[(size_t)i*columnStride];
+
+            int j = 1;
+            for (; j+63<=rowCount; j+=64)
+            {
+                __m512i leftSum = _mm512_add_epi8(_mm512_add_epi8(loadLivingCellsAvx512<Rule>(&left[j-1], rule), loadLivingCellsAvx512<Rule>(&left[j], rule)), loadLivingCellsAvx512<Rule>(&left[j+1], rule));
+                __m512i centerSum = _mm512_add_epi8(loadLivingCellsAvx512<Rule>(&center[j-1], rule), loadLivingCellsAvx512<Rule>(&center[j+1], rule));
+                __m512i rightSum = _mm512_add_epi8(_mm512_add_epi8(loadLivingCellsAvx512<Rule>(&right[j-1], rule), loadLivingCellsAvx512<Rule>(&right[j], rule)), loadLivingCellsAvx512<Rule>(&right[j+1], rule));
+                __m512i livingNeighboursCount = _mm512_add_epi8(_mm512_add_epi8(leftSum, centerSum), rightSum);
+
+                __m512i cell = _mm512_loadu_si512(&center[j]);
+                __mmask64 isAlive = _mm512_cmpeq_epi8_mask(cell, ones);
+                __mmask64 isBirthCount = 0;
+                __mmask64 isSurvivalCount = 0;
+                for (int k=0; k<=8; k++)
+                {
+                    bool isBirth = (Rule::getBirthMask(rule) >> k) & 1;
+                    bool isSurvival = (Rule::getSurvivalMask(rule) >> k) & 1;
+                    if (isBirth || isSurvival)
+                    {
+                        __mmask64 isCountEqual = _mm512_cmpeq_epi8_mask(livingNeighboursCount, _mm512_set1_epi8((char)k));
+                        isBirthCount |= isBirth ? isCountEqual : 0;
+                        isSurvivalCount |= isSurvival ? isCountEqual : 0;
+                    }
+                }
+
+                if (Rule::getStateCount(rule) == 2)
+                {
+                    __mmask64 nextGeneration = (isBirthCount & ~isAlive) | (isSurvivalCount & isAlive);
+                    _mm512_storeu_si512(&output[j], _mm512_maskz_mov_epi8(nextGeneration, ones));
+                }
+                else
+                {
+                    __mmask64 isDead = _mm512_cmpeq_epi8_mask(cell, _mm512_setzero_si512());
+                    __mmask64 isSurviving = isAlive & isSurvivalCount;
+                    __m512i agedCell = _mm512_add_epi8(cell, ones);
+                    __mmask64 isAging = ~(isDead | isSurviving | _mm512_cmpeq_epi8_mask(agedCell, stateCounts));
+                    __m512i nextGeneration = _mm512_mask_mov_epi8(_mm512_maskz_mov_epi8(isAging, agedCell), (isDead & isBirthCount) | isSurviving, ones);
+                    _mm512_storeu_si512(&output[j], nextGeneration);
+                }
+            }
+            for (; j<=rowCount; j++)
+            {
+                output[j] = calculateCell<Rule>(&center[j], columnStride, rule);
+            }
+        }
+    }
+#endif
+}
+
+SimdCellEngine::SimdCellEngine(bool isScalarForced)
+:mColumnCount(0),
+mRowCount(0),
+mColumnStride(0),
+mTopology(BoardTopology::deadBorder),
+mInstructionSet(InstructionSet::scalar),
+mInstructionSetName("scalar")
+{
+#ifdef GAMEOFLIFE_X86_SIMD
+    if (!isScalarForced)
+    {
+        //CPUID is only queried once, every following generation just calls through the chosen function
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        {
+            mInstructionSet = InstructionSet::avx512;
+            mInstructionSetName = "AVX-512";
+        }
+        else if (__builtin_cpu_supports("avx2"))
+        {
+            mInstructionSet = InstructionSet::avx2;
+            mInstructionSetName = "AVX2";
+        }
+        else
+        {
+            mInstructionSet = InstructionSet::sse2;
+            mInstructionSetName = "SSE2";
+        }
+    }
+#endif
+    setRule(LifeRule::conway());
+}
+
+void SimdCellEngine::setCells(const CellGrid& cellGrid)
+{
+    mColumnCount = cellGrid.getColumnCount();
+    mRowCount = cellGrid.getRowCount();
+    mColumnStride = mRowCount+2;
+    mInputCellValues.assign((size_t)(mColumnCount+2)*mColumnStride, 0);
+    mOutputCellValues.assign((size_t)(mColumnCount+2)*mColumnStride, 0);
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        std::copy_n(cellGrid.getData()+(size_t)i*cellGrid.getColumnStride(), mRowCount, &mInputCellValues[(size_t)(i+1)*mColumnStride+1]);
+    }
+}
+
+void SimdCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        fillHalo();
+        mCalculateColumns(mInputCellValues.data(), mOutputCellValues.data(), mColumnCount, mRowCount, mColumnStride, mRule);
+        mInputCellValues.swap(mOutputCellValues);
+    }
+}
+
+void SimdCellEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        std::copy_n(&mInputCellValues[(size_t)(i+1)*mColumnStride+1], mRowCount, cellGrid.getData()+(size_t)i*cellGrid.getColumnStride());
+    }
+}
+
+void SimdCellEngine::setTopology(BoardTopology topology)
+{
+    mTopology = topology;
+}
+
+void SimdCellEngine::setRule(const LifeRule& rule)
+{
+    //function is picked for both the instruction set and the rule
+    mRule = rule;
+    mCalculateColumns = selectLifeRule(rule, [this](auto selectedRule) -> CalculateColumnsFunction
+    {
+        using Rule = decltype(selectedRule);
+#ifdef GAMEOFLIFE_X86_SIMD
+        if (mInstructionSet == InstructionSet::avx512)
+        {
+            return calculateColumnsAvx512<Rule>;
+        }
+        if (mInstructionSet == InstructionSet::avx2)
+        {
+            return calculateColumnsAvx2<Rule>;
+        }
+        if (mInstructionSet == InstructionSet::sse2)
+        {
+            return calculateColumnsSse2<Rule>;
+        }
+#endif
+        return calculateColumnsScalar<Rule>;
+    });
+}
+
+bool SimdCellEngine::isRuleSupported(const LifeRule& rule) const
+{
+    //halo is a single cell wide
+    return !rule.hasExtendedNeighbourhood();
+}
+
+std::string SimdCellEngine::getName() const
+{
+    return "CPU SIMD ("+mInstructionSetName+")";
+}
+
+void SimdCellEngine::fillHalo()
+{
+    //halo of a dead border is never written to, so it stays dead in both buffers
+    if (mTopology == BoardTopology::deadBorder)
+    {
+        return;
+    }
+
+    //halo cells above and below every column come from the other end of the same column, or the reversed one for Klein bottle
+    for (int i=1; i<=mColumnCount; i++)
+    {
+        int wrappedColumn = (mTopology == BoardTopology::kleinBottle) ? mColumnCount+1-i : i;
+        mInputCellValues[(size_t)i*mColumnStride] = mInputCellValues[(size_t)wrappedColumn*mColumnStride+mRowCount];
+        mInputCellValues[(size_t)i*mColumnStride+mRowCount+1] = mInputCellValues[(size_t)wrappedColumn*mColumnStride+1];
+    }
+
+    //whole halo columns are copied afterwards, so they already contain the corners
+    std::copy_n(&mInputCellValues[(size_t)mColumnCount*mColumnStride], mColumnStride, &mInputCellValues[0]);
+    std::copy_n(&mInputCellValues[(size_t)1*mColumnStride], mColumnStride, &mInputCellValues[(size_t)(mColumnCount+1)*mColumnStride]);
+}
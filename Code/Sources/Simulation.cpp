@@ -0,0 +1,116 @@
+#include "../Headers/Simulation.h"
+
+#include <iostream>
+
+#include "../Headers/CellEngineFactory.h"
+
+Simulation::Simulation(int columnCount, int rowCount, const LifeRule& rule)
+:mCellGrid(columnCount, rowCount),
+mCurrentCellEngineIndex(0),
+mTopology(BoardTopology::deadBorder),
+mRule(rule),
+mIsCellGridOutdated(false),
+mIsCellEngineOutdated(true)
+{
+    mCellEngines = CellEngineFactory::createEnginesForRule(mRule, mTopology);
+    std::cout << "Using rule: " << mRule.toString() << std::endl;
+}
+
+void Simulation::setCellValue(int column, int row, int cellValue)
+{
+    synchronizeCellGridWithEngine();
+    mCellGrid.setCellValue(column, row, cellValue);
+    mIsCellEngineOutdated = true;
+}
+
+void Simulation::resize(int columnCount, int rowCount)
+{
+    //pattern survives resizing, so the newest generation has to be fetched from the engine before the board changes
+    synchronizeCellGridWithEngine();
+    mCellGrid.resize(columnCount, rowCount);
+    mIsCellEngineOutdated = true;
+}
+
+void Simulation::placePattern(const CellGrid& pattern)
+{
+    synchronizeCellGridWithEngine();
+    mCellGrid.clear();
+    int columnOffset = (mCellGrid.getColumnCount()-pattern.getColumnCount())/2;
+    int rowOffset = (mCellGrid.getRowCount()-pattern.getRowCount())/2;
+    for (int column=0; column<pattern.getColumnCount(); column++)
+    {
+        for (int row=0; row<pattern.getRowCount(); row++)
+        {
+            //dying states of a Generations pattern loaded for a rule with fewer states are dead
+            int cellValue = pattern.getCellValue(column, row);
+            if (mCellGrid.containsCell(column+columnOffset, row+rowOffset) && cellValue < mRule.stateCount)
+            {
+                mCellGrid.setCellValue(column+columnOffset, row+rowOffset, cellValue);
+            }
+        }
+    }
+    mIsCellEngineOutdated = true;
+}
+
+void Simulation::calculateNextGenerations(int generationCount)
+{
+    CellEngine& cellEngine = getCellEngine();
+    if (mIsCellEngineOutdated)
+    {
+        cellEngine.setCells(mCellGrid);
+        mIsCellEngineOutdated = false;
+    }
+
+    cellEngine.calculateNextGenerations(generationCount);
+    mIsCellGridOutdated = true;
+}
+
+void Simulation::finish()
+{
+    getCellEngine().finish();
+}
+
+bool Simulation::synchronizeCellGridWithEngine()
+{
+    if (!mIsCellGridOutdated)
+    {
+        return false;
+    }
+
+    getCellEngine().getCells(mCellGrid);
+    mIsCellGridOutdated = false;
+    return true;
+}
+
+void Simulation::switchCellEngine()
+{
+    synchronizeCellGridWithEngine();
+    mIsCellEngineOutdated = true;
+    mCurrentCellEngineIndex = (mCurrentCellEngineIndex+1)%mCellEngines.size();
+    std::cout << "Using cell engine: " << getCellEngine().getName() << std::endl;
+    reportUnsupportedTopology();
+}
+
+void Simulation::switchTopology()
+{
+    synchronizeCellGridWithEngine();
+    mTopology = (BoardTopology)(((int)mTopology+1)%3);
+    //new topology only takes effect once engines receive the board again
+    for (auto& cellEngine : mCellEngines)
+    {
+        cellEngine->setTopology(mTopology);
+    }
+    mIsCellEngineOutdated = true;
+
+    const char* topologyNames[3] = {"dead border", "torus", "Klein bottle"};
+    std::cout << "Board topology: " << topologyNames[(int)mTopology] << std::endl;
+    reportUnsupportedTopology();
+}
+
+void Simulation::reportUnsupportedTopology()
+{
+    if (!getCellEngine().isTopologySupported(mTopology))
+    {
+        std::cout << "Cell engine " << getCellEngine().getName() << " simulates an unbounded universe and ignores the board topology" << std::endl;
+    }
+}
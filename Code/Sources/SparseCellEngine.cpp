@@ -0,0 +1,123 @@
+#include "../Headers/SparseCellEngine.h"
+
+//every tile is a single word wide, so 64 rows make it square
+#define tileRowCount 64
+
+SparseCellEngine::SparseCellEngine()
+:mTileColumnCount(0),
+mTileRowCount(0),
+mSkippedTileCount(0),
+mTotalSkippedTileCount(0)
+{
+
+}
+
+void SparseCellEngine::setCells(const CellGrid& cellGrid)
+{
+    BitPackedCellEngine::setCells(cellGrid);
+
+    //nothing is known about the new board yet, so every tile has to be calculated at least once
+    mTileColumnCount = mWordsPerRow;
+    mTileRowCount = (mRowCount+tileRowCount-1)/tileRowCount;
+    mChangedTiles.assign((size_t)mTileColumnCount*mTileRowCount, 1);
+    mNextChangedTiles.assign((size_t)mTileColumnCount*mTileRowCount, 0);
+    mSkippedTileCount = 0;
+    mTotalSkippedTileCount = 0;
+}
+
+void SparseCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        fillGhostCells();
+        //with wrapped edges a change on one edge can affect the opposite one, so all edge tiles are recalculated if any of them changed
+        bool isAnyEdgeTileChanged = mTopology != BoardTopology::deadBorder && isAnyEdgeTileChangedInPreviousGeneration();
+        mSkippedTileCount = 0;
+        for (int tileRow=0; tileRow<mTileRowCount; tileRow++)
+        {
+            for (int tileColumn=0; tileColumn<mTileColumnCount; tileColumn++)
+            {
+                //tile which did not change last generation still holds the same cells in the output buffer (it was the input one generation ago),
+                //so if none of its neighbours changed either, there is nothing to do at all
+                bool isEdgeTile = tileColumn == 0 || tileRow == 0 || tileColumn == mTileColumnCount-1 || tileRow == mTileRowCount-1;
+                if (!isTileOrNeighbourChanged(tileColumn, tileRow) && !(isEdgeTile && isAnyEdgeTileChanged))
+                {
+                    mNextChangedTiles[(size_t)tileRow*mTileColumnCount+tileColumn] = 0;
+                    mSkippedTileCount++;
+                    continue;
+                }
+
+                int firstRow = tileRow*tileRowCount;
+                int lastRow = std::min(firstRow+tileRowCount, mRowCount);
+                calculateTile(firstRow, lastRow, tileColumn, tileColumn+1);
+
+                uint8_t isChanged = 0;
+                for (int j=firstRow; j<lastRow; j++)
+                {
+                    //ghost cells are only filled in the input buffer, so they must not count as changes
+                    isChanged |= ((mInputWords[(size_t)(j+1)*mWordsPerRow+tileColumn] ^ mOutputWords[(size_t)(j+1)*mWordsPerRow+tileColumn]) & mCellMasks[tileColumn]) != 0;
+                }
+                mNextChangedTiles[(size_t)tileRow*mTileColumnCount+tileColumn] = isChanged;
+            }
+        }
+        mTotalSkippedTileCount += mSkippedTileCount;
+        mInputWords.swap(mOutputWords);
+        mChangedTiles.swap(mNextChangedTiles);
+    }
+}
+
+std::string SparseCellEngine::getName() const
+{
+    return "CPU sparse";
+}
+
+int SparseCellEngine::getTileCount() const
+{
+    return mTileColumnCount*mTileRowCount;
+}
+
+int SparseCellEngine::getSkippedTileCount() const
+{
+    return mSkippedTileCount;
+}
+
+uint64_t SparseCellEngine::getTotalSkippedTileCount() const
+{
+    return mTotalSkippedTileCount;
+}
+
+bool SparseCellEngine::isTileOrNeighbourChanged(int tileColumn, int tileRow) const
+{
+    for (int j=std::max(tileRow-1, 0); j<=std::min(tileRow+1, mTileRowCount-1); j++)
+    {
+        for (int i=std::max(tileColumn-1, 0); i<=std::min(tileColumn+1, mTileColumnCount-1); i++)
+        {
+            if (mChangedTiles[(size_t)j*mTileColumnCount+i])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SparseCellEngine::isAnyEdgeTileChangedInPreviousGeneration() const
+{
+    for (int tileRow=0; tileRow<mTileRowCount; tileRow++)
+    {
+        for (int tileColumn=0; tileColumn<mTileColumnCount; tileColumn++)
+        {
+            //only first and last tile of rows in between are on the edge
+            if (tileRow != 0 && tileRow != mTileRowCount-1 && tileColumn != 0 && tileColumn != mTileColumnCount-1)
+            {
+                tileColumn = mTileColumnCount-2;
+                continue;
+            }
+            if (mChangedTiles[(size_t)tileRow*mTileColumnCount+tileColumn])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
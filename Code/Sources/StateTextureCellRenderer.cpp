@@ -0,0 +1,81 @@
+#include "../Headers/StateTextureCellRenderer.h"
+
+StateTextureCellRenderer::StateTextureCellRenderer(const sf::Texture& cellAtlasTexture, int stateCount)
+:mCellAtlasTexture(cellAtlasTexture),
+mColumnCount(0),
+mRowCount(0),
+mIsStateTextureOutdated(false)
+{
+    mCellStateShader.loadFromFile("Resources/Shaders/cellState.frag", sf::Shader::Fragment);
+    mCellStateShader.setUniform("stateTexture", sf::Shader::CurrentTexture);
+    mCellStateShader.setUniform("cellAtlasTexture", mCellAtlasTexture);
+    mCellStateShader.setUniform("stateCount", (float)stateCount);
+}
+
+bool StateTextureCellRenderer::isAvailable(int columnCount, int rowCount)
+{
+    //board has to fit a single texture, sizes are compared as unsigned only once they are known to be positive
+    unsigned int maximumTextureSize = sf::Texture::getMaximumSize();
+    return sf::Shader::isAvailable() && columnCount > 0 && rowCount > 0 &&
+           (unsigned int)columnCount <= maximumTextureSize && (unsigned int)rowCount <= maximumTextureSize;
+}
+
+void StateTextureCellRenderer::setCanvasGeometry(int columnCount, int rowCount, sf::Vector2f canvasOrigin, float cellSize)
+{
+    mColumnCount = columnCount;
+    mRowCount = rowCount;
+    mStatePixels.assign((size_t)mColumnCount*mRowCount*4, 255);
+    for (size_t i=0; i<mStatePixels.size(); i+=4)
+    {
+        mStatePixels[i] = 0;
+    }
+
+    mStateTexture.create(mColumnCount, mRowCount);
+    mStateTexture.setSmooth(false);
+    mStateTexture.update(mStatePixels.data());
+    mIsStateTextureOutdated = false;
+
+    //every texel is stretched to the size of a whole cell
+    mStateSprite.setTexture(mStateTexture, true);
+    mStateSprite.setPosition(canvasOrigin);
+    mStateSprite.setScale(cellSize, cellSize);
+    mCellStateShader.setUniform("boardSize", sf::Glsl::Vec2((float)mColumnCount, (float)mRowCount));
+}
+
+void StateTextureCellRenderer::updateCells(const CellGrid& cellGrid)
+{
+    //texture is stored row by row, while the grid is stored column by column
+    const uint8_t* cellValues = cellGrid.getData();
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            mStatePixels[((size_t)j*mColumnCount+i)*4] = cellValues[(size_t)i*cellGrid.getColumnStride()+j];
+        }
+    }
+    mIsStateTextureOutdated = true;
+}
+
+void StateTextureCellRenderer::updateCell(const CellGrid& cellGrid, int column, int row)
+{
+    mStatePixels[((size_t)row*mColumnCount+column)*4] = (sf::Uint8)cellGrid.getCellValue(column, row);
+    mIsStateTextureOutdated = true;
+}
+
+void StateTextureCellRenderer::draw(sf::RenderWindow& window, const sf::Transform& transform)
+{
+    //whole board is uploaded at most once per drawn frame, no matter how many cells changed in between
+    if (mIsStateTextureOutdated)
+    {
+        mStateTexture.update(mStatePixels.data());
+        mIsStateTextureOutdated = false;
+    }
+    sf::RenderStates renderStates(&mCellStateShader);
+    renderStates.transform = transform;
+    window.draw(mStateSprite, renderStates);
+}
+
+std::string StateTextureCellRenderer::getName() const
+{
+    return "state texture";
+}
@@ -0,0 +1,259 @@
+#include "../Headers/SummedAreaCellEngine.h"
+
+#include <cstdlib>
+
+//rows of the summed-area table calculated by one task, they are independent, while columns depend on the previous one
+#define areaSumRowsPerTask 256
+//same for diagonals of the diagonal sums
+#define diagonalSumDiagonalsPerTask 256
+
+SummedAreaCellEngine::SummedAreaCellEngine(int threadCount)
+:mColumnCount(0),
+mRowCount(0),
+mRange(1),
+mTopology(BoardTopology::deadBorder),
+mRule(LifeRule::conway()),
+mThreadPool(threadCount)
+{
+
+}
+
+void SummedAreaCellEngine::setCells(const CellGrid& cellGrid)
+{
+    mColumnCount = cellGrid.getColumnCount();
+    mRowCount = cellGrid.getRowCount();
+    mInputCellValues.resize((size_t)mColumnCount*mRowCount);
+    mOutputCellValues.resize((size_t)mColumnCount*mRowCount);
+    resizeSums();
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        std::copy_n(cellGrid.getData()+(size_t)i*cellGrid.getColumnStride(), mRowCount, &mInputCellValues[(size_t)i*mRowCount]);
+    }
+}
+
+void SummedAreaCellEngine::calculateNextGenerations(int generationCount)
+{
+    for (int i=0; i<generationCount; i++)
+    {
+        calculateColumnSums();
+        if (mRule.neighbourhood == LifeNeighbourhood::moore)
+        {
+            calculateAreaSums();
+        }
+        else
+        {
+            calculateDiagonalSums();
+        }
+        mThreadPool.runTasks(mColumnCount, [this](int column)
+        {
+            calculateColumn(column);
+        });
+        mInputCellValues.swap(mOutputCellValues);
+    }
+}
+
+void SummedAreaCellEngine::getCells(CellGrid& cellGrid)
+{
+    if (cellGrid.getColumnCount() != mColumnCount || cellGrid.getRowCount() != mRowCount)
+    {
+        cellGrid.resize(mColumnCount, mRowCount);
+    }
+
+    for (int i=0; i<mColumnCount; i++)
+    {
+        std::copy_n(&mInputCellValues[(size_t)i*mRowCount], mRowCount, cellGrid.getData()+(size_t)i*cellGrid.getColumnStride());
+    }
+}
+
+void SummedAreaCellEngine::setTopology(BoardTopology topology)
+{
+    mTopology = topology;
+}
+
+void SummedAreaCellEngine::setRule(const LifeRule& rule)
+{
+    //cells are stored without padding, so only the sums have to follow a new range or neighbourhood
+    mRule = rule;
+    resizeSums();
+}
+
+std::string SummedAreaCellEngine::getName() const
+{
+    return "CPU summed-area tables ("+std::to_string(mThreadPool.getThreadCount())+" threads)";
+}
+
+void SummedAreaCellEngine::resizeSums()
+{
+    //borders of zeros are never written afterwards, so they only have to be cleared here
+    mRange = mRule.range;
+    size_t diagonalSumCount = (mRule.neighbourhood == LifeNeighbourhood::vonNeumann) ? (size_t)(getPaddedColumnCount()+2)*(getPaddedRowCount()+1) : 0;
+    size_t areaSumCount = (mRule.neighbourhood == LifeNeighbourhood::moore) ? (size_t)(getPaddedColumnCount()+1)*(getPaddedRowCount()+1) : 0;
+    mColumnSums.assign((size_t)getPaddedColumnCount()*(getPaddedRowCount()+1), 0);
+    mAreaSums.assign(areaSumCount, 0);
+    mDiagonalSums.assign(diagonalSumCount, 0);
+    mAntiDiagonalSums.assign(diagonalSumCount, 0);
+}
+
+bool SummedAreaCellEngine::wrapCell(int& column, int& row) const
+{
+    if (column>=0 && row>=0 && column<mColumnCount && row<mRowCount)
+    {
+        return true;
+    }
+    if (mTopology == BoardTopology::deadBorder)
+    {
+        return false;
+    }
+
+    //range may be larger than the board, so cells may wrap around it several times, every time reversed again for Klein bottle
+    int rowWrapCount = (row >= 0) ? row/mRowCount : -((mRowCount-1-row)/mRowCount);
+    row -= rowWrapCount*mRowCount;
+    if (mTopology == BoardTopology::kleinBottle && rowWrapCount%2 != 0)
+    {
+        column = mColumnCount-1-column;
+    }
+    column = (column%mColumnCount+mColumnCount)%mColumnCount;
+    return true;
+}
+
+void SummedAreaCellEngine::calculateColumnSums()
+{
+    int paddedRowCount = getPaddedRowCount();
+    mThreadPool.runTasks(getPaddedColumnCount(), [this, paddedRowCount](int paddedColumn)
+    {
+        int* columnSums = &mColumnSums[(size_t)paddedColumn*(paddedRowCount+1)];
+        int livingCellCount = 0;
+        for (int j=0; j<paddedRowCount; j++)
+        {
+            int column = paddedColumn-mRange;
+            int row = j-mRange;
+            if (wrapCell(column, row) && mInputCellValues[(size_t)column*mRowCount+row] == 1)
+            {
+                livingCellCount++;
+            }
+            columnSums[j+1] = livingCellCount;
+        }
+    });
+}
+
+void SummedAreaCellEngine::calculateAreaSums()
+{
+    //first column of the table stays zero, every other one adds column sums of one more padded column
+    int paddedColumnCount = getPaddedColumnCount();
+    int sumRowCount = getPaddedRowCount()+1;
+    mThreadPool.runTasks((sumRowCount+areaSumRowsPerTask-1)/areaSumRowsPerTask, [this, paddedColumnCount, sumRowCount](int task)
+    {
+        int firstRow = task*areaSumRowsPerTask;
+        int lastRow = std::min(firstRow+areaSumRowsPerTask, sumRowCount);
+        for (int i=0; i<paddedColumnCount; i++)
+        {
+            const int* previousAreaSums = &mAreaSums[(size_t)i*sumRowCount];
+            const int* columnSums = &mColumnSums[(size_t)i*sumRowCount];
+            int* areaSums = &mAreaSums[(size_t)(i+1)*sumRowCount];
+            for (int j=firstRow; j<lastRow; j++)
+            {
+                areaSums[j] = previousAreaSums[j]+columnSums[j];
+            }
+        }
+    });
+}
+
+void SummedAreaCellEngine::calculateDiagonalSums()
+{
+    //every diagonal only depends on itself, so tasks take whole diagonals and go through them column by column,
+    //reading single cells from differences of column sums
+    int paddedColumnCount = getPaddedColumnCount();
+    int paddedRowCount = getPaddedRowCount();
+    int diagonalCount = paddedColumnCount+paddedRowCount-1;
+    mThreadPool.runTasks((diagonalCount+diagonalSumDiagonalsPerTask-1)/diagonalSumDiagonalsPerTask, [this, paddedColumnCount, paddedRowCount, diagonalCount](int task)
+    {
+        int firstDiagonal = task*diagonalSumDiagonalsPerTask;
+        int lastDiagonal = std::min(firstDiagonal+diagonalSumDiagonalsPerTask, diagonalCount);
+        auto getCellValue = [this, paddedRowCount](int paddedColumn, int paddedRow)
+        {
+            const int* columnSums = &mColumnSums[(size_t)paddedColumn*(paddedRowCount+1)];
+            return columnSums[paddedRow+1]-columnSums[paddedRow];
+        };
+
+        //diagonal d holds cells with paddedColumn-paddedRow == d-(paddedRowCount-1), the previous cell is one column to the left and one row up
+        for (int i=0; i<paddedColumnCount; i++)
+        {
+            int firstRow = std::max(i-(lastDiagonal-1-(paddedRowCount-1)), 0);
+            int lastRow = std::min(i-(firstDiagonal-(paddedRowCount-1)), paddedRowCount-1);
+            for (int j=firstRow; j<=lastRow; j++)
+            {
+                mDiagonalSums[getDiagonalSumIndex(i, j)] = getCellValue(i, j)+mDiagonalSums[getDiagonalSumIndex(i-1, j-1)];
+            }
+        }
+        //anti-diagonal d holds cells with paddedColumn+paddedRow == d, the previous cell is one column to the right and one row up
+        for (int i=paddedColumnCount-1; i>=0; i--)
+        {
+            int firstRow = std::max(firstDiagonal-i, 0);
+            int lastRow = std::min(lastDiagonal-1-i, paddedRowCount-1);
+            for (int j=firstRow; j<=lastRow; j++)
+            {
+                mAntiDiagonalSums[getDiagonalSumIndex(i, j)] = getCellValue(i, j)+mAntiDiagonalSums[getDiagonalSumIndex(i+1, j-1)];
+            }
+        }
+    });
+}
+
+void SummedAreaCellEngine::calculateColumn(int column)
+{
+    //cell (column, row) of the board is padded cell (column+range, row+range), so its neighbourhood starts at padded cell (column, row)
+    int sumRowCount = getPaddedRowCount()+1;
+    int neighbourhoodSize = 2*mRange+1;
+    int diamondCount = 0;//living cells of the von Neumann neighbourhood including the cell in the middle
+    for (int j=0; j<mRowCount; j++)
+    {
+        int livingNeighboursCount = 0;
+        if (mRule.neighbourhood == LifeNeighbourhood::moore)
+        {
+            const int* leftAreaSums = &mAreaSums[(size_t)column*sumRowCount];
+            const int* rightAreaSums = &mAreaSums[(size_t)(column+neighbourhoodSize)*sumRowCount];
+            livingNeighboursCount = rightAreaSums[j+neighbourhoodSize]-rightAreaSums[j]-leftAreaSums[j+neighbourhoodSize]+leftAreaSums[j];
+        }
+        else if (j == 0)
+        {
+            //diamond is a column of 2*range+1 cells in the middle, getting shorter by two cells with every column towards its sides
+            for (int i=0; i<neighbourhoodSize; i++)
+            {
+                int halfHeight = mRange-std::abs(i-mRange);
+                const int* columnSums = &mColumnSums[(size_t)(column+i)*sumRowCount];
+                diamondCount += columnSums[j+mRange+halfHeight+1]-columnSums[j+mRange-halfHeight];
+            }
+            livingNeighboursCount = diamondCount;
+        }
+        else
+        {
+            //moving one row down gains the lower V of the new diamond and loses the upper one of the previous diamond, each V is
+            //two diagonal runs of cells, so the cost does not depend on the range, (x, y) is the middle of the previous diamond
+            int x = column+mRange;
+            int y = j-1+mRange;
+            diamondCount += mDiagonalSums[getDiagonalSumIndex(x, y+1+mRange)]-mDiagonalSums[getDiagonalSumIndex(x-mRange-1, y)]
+                          + mAntiDiagonalSums[getDiagonalSumIndex(x+1, y+mRange)]-mAntiDiagonalSums[getDiagonalSumIndex(x+mRange+1, y)]
+                          - mAntiDiagonalSums[getDiagonalSumIndex(x-mRange, y)]+mAntiDiagonalSums[getDiagonalSumIndex(x+1, y-mRange-1)]
+                          - mDiagonalSums[getDiagonalSumIndex(x+mRange, y)]+mDiagonalSums[getDiagonalSumIndex(x, y-mRange)];
+            livingNeighboursCount = diamondCount;
+        }
+
+        uint8_t cellValue = mInputCellValues[(size_t)column*mRowCount+j];
+        livingNeighboursCount -= (cellValue == 1) ? 1 : 0;
+
+        uint8_t nextCellValue = 0;
+        if (cellValue == 0)
+        {
+            nextCellValue = mRule.isBirth(livingNeighboursCount) ? 1 : 0;
+        }
+        else if (cellValue == 1 && mRule.isSurvival(livingNeighboursCount))
+        {
+            nextCellValue = 1;
+        }
+        else
+        {
+            nextCellValue = (cellValue+1 < mRule.stateCount) ? cellValue+1 : 0;
+        }
+        mOutputCellValues[(size_t)column*mRowCount+j] = nextCellValue;
+    }
+}
@@ -0,0 +1,145 @@
+#include "../Headers/ThreadPool.h"
+
+namespace
+{
+    uint64_t packTaskRange(uint32_t firstTask, uint32_t lastTask)
+    {
+        return ((uint64_t)firstTask << 32) | lastTask;
+    }
+}
+
+ThreadPool::ThreadPool(int threadCount)
+:mTaskRanges(threadCount > 0 ? threadCount : 1),
+mBatchNumber(0),
+mBusyWorkerCount(0),
+mIsStopping(false)
+{
+    //calling thread always works as worker number 0, so only the remaining ones have to be started
+    for (int i=1; i<(int)mTaskRanges.size(); i++)
+    {
+        mThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+    mBatchStartCondition.notify_all();
+
+    for (size_t i=0; i<mThreads.size(); i++)
+    {
+        mThreads[i].join();
+    }
+}
+
+int ThreadPool::getThreadCount() const
+{
+    return (int)mTaskRanges.size();
+}
+
+void ThreadPool::runTasks(int taskCount, const std::function<void(int)>& task)
+{
+    if (taskCount <= 0)
+    {
+        return;
+    }
+
+    mTask = task;
+    int workerCount = (int)mTaskRanges.size();
+    for (int i=0; i<workerCount; i++)
+    {
+        mTaskRanges[i].range.store(packTaskRange((uint64_t)taskCount*i/workerCount, (uint64_t)taskCount*(i+1)/workerCount));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBusyWorkerCount = workerCount-1;
+        mBatchNumber++;
+    }
+    mBatchStartCondition.notify_all();
+
+    processTasks(0);
+
+    //workers only stop looking for tasks once none are left to steal, so when all of them are idle every task has finished
+    std::unique_lock<std::mutex> lock(mMutex);
+    mBatchFinishCondition.wait(lock, [this]{ return mBusyWorkerCount == 0; });
+}
+
+void ThreadPool::workerLoop(int workerIndex)
+{
+    uint64_t lastBatchNumber = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mBatchStartCondition.wait(lock, [this, lastBatchNumber]{ return mIsStopping || mBatchNumber != lastBatchNumber; });
+            if (mIsStopping)
+            {
+                return;
+            }
+            lastBatchNumber = mBatchNumber;
+        }
+
+        processTasks(workerIndex);
+
+        bool isLastBusyWorker;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mBusyWorkerCount--;
+            isLastBusyWorker = mBusyWorkerCount == 0;
+        }
+        if (isLastBusyWorker)
+        {
+            mBatchFinishCondition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::processTasks(int workerIndex)
+{
+    std::atomic<uint64_t>& ownRange = mTaskRanges[workerIndex].range;
+    while (true)
+    {
+        uint64_t range = ownRange.load();
+        uint32_t firstTask = (uint32_t)(range >> 32);
+        uint32_t lastTask = (uint32_t)range;
+        if (firstTask < lastTask)
+        {
+            //owner takes tasks from the front of its range, thieves take them from the back
+            if (ownRange.compare_exchange_weak(range, packTaskRange(firstTask+1, lastTask)))
+            {
+                mTask((int)firstTask);
+            }
+        }
+        else if (!stealTasks(workerIndex))
+        {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::stealTasks(int workerIndex)
+{
+    int workerCount = (int)mTaskRanges.size();
+    for (int i=1; i<workerCount; i++)
+    {
+        std::atomic<uint64_t>& victimRange = mTaskRanges[(workerIndex+i)%workerCount].range;
+        uint64_t range = victimRange.load();
+        while ((uint32_t)(range >> 32) < (uint32_t)range)
+        {
+            uint32_t firstTask = (uint32_t)(range >> 32);
+            uint32_t lastTask = (uint32_t)range;
+            uint32_t newLastTask = lastTask-(lastTask-firstTask+1)/2;
+            if (victimRange.compare_exchange_weak(range, packTaskRange(firstTask, newLastTask)))
+            {
+                //own range is empty at this point, so nobody else can be modifying it
+                mTaskRanges[workerIndex].range.store(packTaskRange(newLastTask, lastTask));
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,33 @@
+#include "../Headers/ThreadedCellEngine.h"
+
+//128 rows of 16 words is 16KB of input and 16KB of output per tile, which comfortably fits in L2 cache of any modern core
+#define tileRowCount 128
+#define tileWordCount 16
+
+ThreadedCellEngine::ThreadedCellEngine(int threadCount)
+:mThreadPool(threadCount)
+{
+
+}
+
+void ThreadedCellEngine::calculateNextGenerations(int generationCount)
+{
+    int tileColumnCount = (mWordsPerRow+tileWordCount-1)/tileWordCount;
+    int tileCount = tileColumnCount*((mRowCount+tileRowCount-1)/tileRowCount);
+    for (int i=0; i<generationCount; i++)
+    {
+        fillGhostCells();
+        mThreadPool.runTasks(tileCount, [this, tileColumnCount](int tile)
+        {
+            int firstRow = tile/tileColumnCount*tileRowCount;
+            int firstWord = tile%tileColumnCount*tileWordCount;
+            calculateTile(firstRow, std::min(firstRow+tileRowCount, mRowCount), firstWord, std::min(firstWord+tileWordCount, mWordsPerRow));
+        });
+        mInputWords.swap(mOutputWords);
+    }
+}
+
+std::string ThreadedCellEngine::getName() const
+{
+    return "CPU threaded ("+std::to_string(mThreadPool.getThreadCount())+" threads)";
+}
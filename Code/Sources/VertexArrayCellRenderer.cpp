@@ -0,0 +1,86 @@
+#include "../Headers/VertexArrayCellRenderer.h"
+
+VertexArrayCellRenderer::VertexArrayCellRenderer(const sf::Texture& cellAtlasTexture, int stateCount)
+:mCellAtlasTexture(cellAtlasTexture),
+mCellTextureSize((float)cellAtlasTexture.getSize().y),
+mStateCount(stateCount),
+mColumnCount(0),
+mRowCount(0),
+mCellVertices(sf::Quads)
+{
+
+}
+
+void VertexArrayCellRenderer::setCanvasGeometry(int columnCount, int rowCount, sf::Vector2f canvasOrigin, float cellSize)
+{
+    mColumnCount = columnCount;
+    mRowCount = rowCount;
+    mCellVertices.resize((size_t)mColumnCount*mRowCount*4);
+    mDrawnCellValues.assign((size_t)mColumnCount*mRowCount, 0);
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            sf::Vertex* quad = &mCellVertices[((size_t)i*mRowCount+j)*4];
+            sf::Vector2f position = canvasOrigin+sf::Vector2f(i*cellSize, j*cellSize);
+            quad[0].position = position;
+            quad[1].position = position+sf::Vector2f(cellSize, 0);
+            quad[2].position = position+sf::Vector2f(cellSize, cellSize);
+            quad[3].position = position+sf::Vector2f(0, cellSize);
+            updateCellQuad(i, j, 0);
+        }
+    }
+}
+
+void VertexArrayCellRenderer::updateCells(const CellGrid& cellGrid)
+{
+    const uint8_t* cellValues = cellGrid.getData();
+    for (int i=0; i<mColumnCount; i++)
+    {
+        for (int j=0; j<mRowCount; j++)
+        {
+            int cellValue = cellValues[(size_t)i*cellGrid.getColumnStride()+j];
+            if (cellValue != mDrawnCellValues[(size_t)i*mRowCount+j])
+            {
+                updateCellQuad(i, j, cellValue);
+            }
+        }
+    }
+}
+
+void VertexArrayCellRenderer::updateCell(const CellGrid& cellGrid, int column, int row)
+{
+    updateCellQuad(column, row, cellGrid.getCellValue(column, row));
+}
+
+void VertexArrayCellRenderer::draw(sf::RenderWindow& window, const sf::Transform& transform)
+{
+    sf::RenderStates renderStates(&mCellAtlasTexture);
+    renderStates.transform = transform;
+    window.draw(mCellVertices, renderStates);
+}
+
+std::string VertexArrayCellRenderer::getName() const
+{
+    return "vertex array";
+}
+
+void VertexArrayCellRenderer::updateCellQuad(int column, int row, int cellValue)
+{
+    size_t cell = (size_t)column*mRowCount+row;
+    mDrawnCellValues[cell] = cellValue;
+
+    //dying cells use the alive cell image, vertex colour multiplies it, so they fade out towards the last dying state
+    float textureOffset = (cellValue != 0) ? mCellTextureSize : 0;
+    sf::Uint8 brightness = (sf::Uint8)(255*CellRenderer::getCellBrightness(cellValue, mStateCount));
+    sf::Color color(brightness, brightness, brightness);
+    sf::Vertex* quad = &mCellVertices[cell*4];
+    quad[0].texCoords = sf::Vector2f(textureOffset, 0);
+    quad[1].texCoords = sf::Vector2f(textureOffset+mCellTextureSize, 0);
+    quad[2].texCoords = sf::Vector2f(textureOffset+mCellTextureSize, mCellTextureSize);
+    quad[3].texCoords = sf::Vector2f(textureOffset, mCellTextureSize);
+    for (int i=0; i<4; i++)
+    {
+        quad[i].color = color;
+    }
+}
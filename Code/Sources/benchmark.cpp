@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Headers/CellGrid.h"
+#include "../Headers/CellEngine.h"
+#include "../Headers/CellEngineFactory.h"
+#include "../Headers/ChunkedCellEngine.h"
+#include "../Headers/SparseCellEngine.h"
+
+//measures every combination of board size, density of a random soup, rule and engine, every combination is timed several times from the same
+//starting soup and reported as generations and cell updates per second with their spread, results are written as JSON, for example:
+//GameOfLifeBenchmark --output benchmark.json --sizes 1024,1048576 --densities 0.2,0.5 --rule B3/S23 --rule B2/S/C3 --engines simd,threaded --repetitions 5
+
+struct BenchmarkStatistics
+{
+    double mean, standardDeviation, minimum, maximum;
+};
+
+//splitmix64, far faster than standard distributions, which matters when filling boards of a billion cells
+static uint64_t nextRandomNumber(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void fillWithRandomSoup(CellGrid& cellGrid, double density, uint64_t seed)
+{
+    //every random number decides four cells, 16 bits each
+    uint32_t threshold = (uint32_t)std::round(std::clamp(density, 0.0, 1.0)*65536.0);
+    uint64_t state = seed;
+    for (int column=0; column<cellGrid.getColumnCount(); column++)
+    {
+        uint8_t* cellValues = cellGrid.getData()+(size_t)column*cellGrid.getColumnStride();
+        for (int row=0; row<cellGrid.getRowCount(); row+=4)
+        {
+            uint64_t randomNumber = nextRandomNumber(state);
+            for (int i=0; i<4 && row+i<cellGrid.getRowCount(); i++)
+            {
+                cellValues[row+i] = ((randomNumber >> (16*i)) & 0xFFFF) < threshold;
+            }
+        }
+    }
+}
+
+static BenchmarkStatistics calculateStatistics(const std::vector<double>& samples)
+{
+    BenchmarkStatistics statistics = {0, 0, samples.front(), samples.front()};
+    for (double sample : samples)
+    {
+        statistics.mean += sample;
+        statistics.minimum = std::min(statistics.minimum, sample);
+        statistics.maximum = std::max(statistics.maximum, sample);
+    }
+    statistics.mean /= samples.size();
+    //sample standard deviation, zero for a single repetition
+    if (samples.size() > 1)
+    {
+        for (double sample : samples)
+        {
+            statistics.standardDeviation += (sample-statistics.mean)*(sample-statistics.mean);
+        }
+        statistics.standardDeviation = std::sqrt(statistics.standardDeviation/(samples.size()-1));
+    }
+    return statistics;
+}
+
+static std::string toJsonString(const std::string& text)
+{
+    std::string jsonString = "\"";
+    for (char character : text)
+    {
+        if (character == '"' || character == '\\')
+        {
+            jsonString += '\\';
+        }
+        jsonString += character;
+    }
+    return jsonString+"\"";
+}
+
+static std::string toJsonObject(const BenchmarkStatistics& statistics)
+{
+    std::ostringstream jsonObject;
+    jsonObject.precision(6);
+    jsonObject << "{\"mean\": " << statistics.mean << ", \"standardDeviation\": " << statistics.standardDeviation
+               << ", \"minimum\": " << statistics.minimum << ", \"maximum\": " << statistics.maximum << "}";
+    return jsonObject.str();
+}
+
+static std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream listStream(list);
+    std::string item;
+    while (std::getline(listStream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+//starts every measured run from the same soup, so all repetitions calculate exactly the same generations
+static double measureRun(CellEngine& cellEngine, const CellGrid& cellGrid, int generationCount)
+{
+    cellEngine.setCells(cellGrid);
+    cellEngine.finish();
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    cellEngine.calculateNextGenerations(generationCount);
+    cellEngine.finish();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-begin).count();
+}
+
+int main(int argc, char* argv[])
+{
+    //sizes in cells, boards are as close to square as possible
+    std::vector<long long> cellCounts = {1LL << 10, 1LL << 15, 1LL << 20, 1LL << 25, 1LL << 30};
+    std::vector<double> densities = {0.2, 0.5};
+    std::vector<LifeRule> rules;
+    std::vector<std::string> engineIds;
+    int repetitionCount = 5;
+    double minimumRunTime = 0.2;//generations per run are doubled until a single run takes at least this many seconds
+    uint64_t seed = 1;
+    std::string outputFilepath = "benchmark.json";
+    const std::string usage = "usage: GameOfLifeBenchmark [--output benchmark.json] [--sizes 1024,1048576,...] [--densities 0.2,0.5] [--rule B3/S23 ...] "
+                              "[--engines simd,threaded,...] [--repetitions 5] [--run-time 0.2] [--seed 1]";
+
+    for (int i=1; i<argc; i++)
+    {
+        std::string argument = argv[i];
+        if (i+1 >= argc)
+        {
+            std::cout << "Unknown argument or missing value: " << argument << ", " << usage << std::endl;
+            return 1;
+        }
+
+        std::string value = argv[++i];
+        try
+        {
+            if (argument == "--output")
+            {
+                outputFilepath = value;
+            }
+            else if (argument == "--sizes")
+            {
+                cellCounts.clear();
+                for (const std::string& item : splitList(value))
+                {
+                    cellCounts.push_back(std::stoll(item));
+                }
+            }
+            else if (argument == "--densities")
+            {
+                densities.clear();
+                for (const std::string& item : splitList(value))
+                {
+                    densities.push_back(std::stod(item));
+                }
+            }
+            //rules are given one by one, since Larger than Life rules contain commas themselves
+            else if (argument == "--rule")
+            {
+                LifeRule rule;
+                if (!LifeRule::parse(value, rule))
+                {
+                    std::cout << "Invalid rule: " << value << ", expected B/S, B/S/C or Larger than Life notation such as B3/S23, B2/S345/C4 or R5,C0,M1,S34..58,B34..45,NM" << std::endl;
+                    return 1;
+                }
+                rules.push_back(rule);
+            }
+            else if (argument == "--engines")
+            {
+                engineIds = splitList(value);
+            }
+            else if (argument == "--repetitions")
+            {
+                repetitionCount = std::stoi(value);
+            }
+            else if (argument == "--run-time")
+            {
+                minimumRunTime = std::stod(value);
+            }
+            else if (argument == "--seed")
+            {
+                seed = std::stoull(value);
+            }
+            else
+            {
+                std::cout << "Unknown argument: " << argument << ", " << usage << std::endl;
+                return 1;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cout << "Invalid value of " << argument << ": " << value << std::endl;
+            return 1;
+        }
+    }
+    for (long long cellCount : cellCounts)
+    {
+        if (cellCount < 1 || cellCount > (1LL << 40))
+        {
+            std::cout << "Board size out of range: " << cellCount << std::endl;
+            return 1;
+        }
+    }
+    if (repetitionCount < 1 || cellCounts.empty() || densities.empty())
+    {
+        std::cout << "Nothing to measure, " << usage << std::endl;
+        return 1;
+    }
+    if (rules.empty())
+    {
+        rules.push_back(LifeRule::conway());
+    }
+    //HashLife and chunked engines simulate an unbounded universe, so their cost follows the pattern rather than the board size, and the sparse
+    //engine only skips tiles which did not change, so its cost follows the active part of the board, random soups are the worst case for all three,
+    //so they are left out by default
+    if (engineIds.empty())
+    {
+        for (const std::string& engineId : CellEngineFactory::getEngineIds())
+        {
+            if (engineId != "sparse" && engineId != "hashlife" && engineId != "chunked")
+            {
+                engineIds.push_back(engineId);
+            }
+        }
+    }
+
+    std::ofstream outputFile(outputFilepath);
+    if (!outputFile.is_open())
+    {
+        std::cout << "Cannot create output file " << outputFilepath << std::endl;
+        return 1;
+    }
+    outputFile << "{\n  \"repetitions\": " << repetitionCount << ",\n  \"minimumRunTime\": " << minimumRunTime << ",\n  \"seed\": " << seed
+               << ",\n  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [";
+    bool isFirstResult = true;
+
+    for (const std::string& engineId : engineIds)
+    {
+        std::unique_ptr<CellEngine> cellEngine = CellEngineFactory::createEngine(engineId);
+        if (cellEngine == nullptr)
+        {
+            std::cout << "Unknown cell engine: " << engineId << ", skipping it" << std::endl;
+            continue;
+        }
+
+        for (const LifeRule& rule : rules)
+        {
+            if (!cellEngine->isRuleSupported(rule))
+            {
+                std::cout << "Cell engine " << cellEngine->getName() << " does not support rule " << rule.toString() << std::endl;
+                continue;
+            }
+            cellEngine->setRule(rule);
+
+            for (long long cellCount : cellCounts)
+            {
+                int columnCount = std::max(1, (int)std::llround(std::sqrt((double)cellCount)));
+                int rowCount = (int)std::max(1LL, cellCount/columnCount);
+                for (double density : densities)
+                {
+                    std::cout << cellEngine->getName() << ", " << rule.toString() << ", " << columnCount << "x" << rowCount << ", density " << density << ": " << std::flush;
+
+                    std::vector<double> generationsPerSecond, cellUpdatesPerSecond;
+                    //engines skipping work report how much of the board they skipped, which explains most of their speed
+                    std::vector<double> skippedTileFractions, chunkCounts;
+                    int generationCount = 1;
+                    try
+                    {
+                        CellGrid cellGrid(columnCount, rowCount);
+                        fillWithRandomSoup(cellGrid, density, seed);
+
+                        //warm-up run pays for first touches of memory and for building OpenCL programs, then the run is made long enough
+                        //for the clock resolution and launch overheads not to matter
+                        measureRun(*cellEngine, cellGrid, 1);
+                        while (measureRun(*cellEngine, cellGrid, generationCount) < minimumRunTime && generationCount < (1 << 20))
+                        {
+                            generationCount *= 2;
+                        }
+                        for (int repetition=0; repetition<repetitionCount; repetition++)
+                        {
+                            double runTime = std::max(measureRun(*cellEngine, cellGrid, generationCount), 1e-9);
+                            generationsPerSecond.push_back(generationCount/runTime);
+                            cellUpdatesPerSecond.push_back((double)columnCount*rowCount*generationCount/runTime);
+                            if (SparseCellEngine* sparseCellEngine = dynamic_cast<SparseCellEngine*>(cellEngine.get()))
+                            {
+                                skippedTileFractions.push_back((double)sparseCellEngine->getTotalSkippedTileCount()/((double)sparseCellEngine->getTileCount()*generationCount));
+                            }
+                            if (ChunkedCellEngine* chunkedCellEngine = dynamic_cast<ChunkedCellEngine*>(cellEngine.get()))
+                            {
+                                chunkCounts.push_back((double)chunkedCellEngine->getChunkCount());
+                            }
+                        }
+                    }
+                    catch (const std::bad_alloc&)
+                    {
+                        std::cout << "not enough memory, skipping" << std::endl;
+                        continue;
+                    }
+
+                    BenchmarkStatistics generationStatistics = calculateStatistics(generationsPerSecond);
+                    BenchmarkStatistics cellUpdateStatistics = calculateStatistics(cellUpdatesPerSecond);
+                    std::cout << cellUpdateStatistics.mean << " cell updates per second" << std::endl;
+
+                    outputFile << (isFirstResult ? "\n" : ",\n");
+                    isFirstResult = false;
+                    outputFile << "    {\"engineId\": " << toJsonString(engineId) << ", \"engine\": " << toJsonString(cellEngine->getName())
+                               << ", \"rule\": " << toJsonString(rule.toString()) << ", \"columns\": " << columnCount << ", \"rows\": " << rowCount
+                               << ", \"cells\": " << (long long)columnCount*rowCount << ", \"density\": " << density
+                               << ", \"generationsPerRun\": " << generationCount
+                               << ", \"generationsPerSecond\": " << toJsonObject(generationStatistics)
+                               << ", \"cellUpdatesPerSecond\": " << toJsonObject(cellUpdateStatistics);
+                    if (!skippedTileFractions.empty())
+                    {
+                        outputFile << ", \"skippedTileFraction\": " << toJsonObject(calculateStatistics(skippedTileFractions));
+                    }
+                    if (!chunkCounts.empty())
+                    {
+                        outputFile << ", \"chunks\": " << toJsonObject(calculateStatistics(chunkCounts));
+                    }
+                    outputFile << "}";
+                }
+            }
+        }
+    }
+
+    outputFile << "\n  ]\n}\n";
+    std::cout << "Results written to " << outputFilepath << std::endl;
+    return 0;
+}
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../Headers/CellGrid.h"
+#include "../Headers/CellEngine.h"
+#include "../Headers/CellEngineFactory.h"
+#include "../Headers/ChunkedCellEngine.h"
+#include "../Headers/SparseCellEngine.h"
+#include "../Headers/PatternFile.h"
+#include "../Headers/MacrocellFile.h"
+
+//command-line driver running the simulation without any window, for example:
+//GameOfLifeHeadless --input glider.rle --output result.rle --generations 1000 --engine simd --rule B3/S23 --topology torus --width 512 --height 512
+//macrocell patterns run with HashLife never pass through a dense board, so universes far larger than any board can be loaded, run and saved
+static int runMacrocellPatternInHashLife(const std::string& inputFilepath, const std::string& outputFilepath, uint64_t generationCount, LifeRule rule, bool isRuleGiven,
+                                         BoardTopology topology, const std::string& topologyName)
+{
+    if (!outputFilepath.empty() && !MacrocellFile::isMacrocell(outputFilepath))
+    {
+        std::cout << "Macrocell patterns run with HashLife can only be saved as macrocell files" << std::endl;
+        return 1;
+    }
+
+    HashLifeEngine hashLifeEngine;
+    if (!hashLifeEngine.isTopologySupported(topology))
+    {
+        std::cout << "Cell engine " << hashLifeEngine.getName() << " simulates an unbounded universe and does not support topology " << topologyName << std::endl;
+        return 1;
+    }
+    LifeRule patternRule = rule;
+    if (!MacrocellFile::load(inputFilepath, hashLifeEngine, patternRule))
+    {
+        return 1;
+    }
+    if (!isRuleGiven)
+    {
+        rule = patternRule;
+    }
+    if (!hashLifeEngine.isRuleSupported(rule))
+    {
+        std::cout << "Cell engine " << hashLifeEngine.getName() << " does not support rule " << rule.toString() << std::endl;
+        return 1;
+    }
+    hashLifeEngine.setRule(rule);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    hashLifeEngine.advanceByGenerations(generationCount);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::cout << "Cell engine: " << hashLifeEngine.getName() << std::endl;
+    std::cout << "Rule: " << rule.toString() << std::endl;
+    std::cout << "Generations: " << generationCount << ", quadtree nodes: " << hashLifeEngine.getNodeCount() << std::endl;
+    std::cout << "Time: " << std::chrono::duration<double>(end-begin).count() << " s" << std::endl;
+    std::cout << "Population: " << hashLifeEngine.getPopulation() << std::endl;
+
+    if (!outputFilepath.empty() && !MacrocellFile::save(outputFilepath, hashLifeEngine, rule))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string inputFilepath, outputFilepath, engineId;
+    uint64_t generationCount = 0;
+    int columnCount = 0, rowCount = 0;//0 keeps the size of the pattern
+    LifeRule rule = LifeRule::conway();
+    bool isRuleGiven = false;//rule given on the command line wins over the one named by the pattern file
+    BoardTopology topology = BoardTopology::deadBorder;
+    std::string topologyName = "deadBorder";
+    bool isWindowGiven = false;//only the window of the board size at these coordinates of a macrocell universe is loaded
+    int64_t windowLeft = 0, windowTop = 0;
+    const std::string usage = "usage: GameOfLifeHeadless --input pattern.rle|pattern.mc|pattern.cells [--output result.rle|result.mc|result.cells] [--generations N] [--engine id] [--rule B3/S23] "
+                              "[--topology deadBorder|torus|kleinBottle] [--width columns] [--height rows] [--window left,top] | --list-engines";
+
+    for (int i=1; i<argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--list-engines")
+        {
+            for (const std::string& availableEngineId : CellEngineFactory::getEngineIds())
+            {
+                std::cout << availableEngineId << std::endl;
+            }
+            return 0;
+        }
+        if (i+1 >= argc)
+        {
+            std::cout << "Unknown argument or missing value: " << argument << ", " << usage << std::endl;
+            return 1;
+        }
+
+        std::string value = argv[++i];
+        if (argument == "--input")
+        {
+            inputFilepath = value;
+        }
+        else if (argument == "--output")
+        {
+            outputFilepath = value;
+        }
+        else if (argument == "--engine")
+        {
+            engineId = value;
+        }
+        else if (argument == "--rule")
+        {
+            if (!LifeRule::parse(value, rule))
+            {
+                std::cout << "Invalid rule: " << value << ", expected B/S, B/S/C or Larger than Life notation such as B3/S23, B2/S345/C4 or R5,C0,M1,S34..58,B34..45,NM" << std::endl;
+                return 1;
+            }
+            isRuleGiven = true;
+        }
+        else if (argument == "--topology")
+        {
+            topologyName = value;
+            if (value == "deadBorder")
+            {
+                topology = BoardTopology::deadBorder;
+            }
+            else if (value == "torus")
+            {
+                topology = BoardTopology::torus;
+            }
+            else if (value == "kleinBottle")
+            {
+                topology = BoardTopology::kleinBottle;
+            }
+            else
+            {
+                std::cout << "Unknown topology: " << value << ", expected deadBorder, torus or kleinBottle" << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--window")
+        {
+            //coordinates of the top left cell of the window, relative to the center of the macrocell universe, so they may be negative
+            size_t separator = value.find(',');
+            try
+            {
+                size_t leftLength = 0, topLength = 0;
+                windowLeft = std::stoll(value.substr(0, separator), &leftLength);
+                windowTop = std::stoll(value.substr(separator+1), &topLength);
+                isWindowGiven = separator != std::string::npos && leftLength == separator && topLength == value.size()-separator-1;
+            }
+            catch (const std::exception&)
+            {
+                isWindowGiven = false;
+            }
+            if (!isWindowGiven)
+            {
+                std::cout << "Expected left,top coordinates after --window, got " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--generations" || argument == "--width" || argument == "--height")
+        {
+            //HashLife runs billions of generations, far more than an int holds, board sizes stay ints
+            long long number;
+            try
+            {
+                number = std::stoll(value);
+            }
+            catch (const std::exception&)
+            {
+                number = -1;
+            }
+            if (number < 0 || (argument != "--generations" && number > INT_MAX))
+            {
+                std::cout << "Expected a non-negative number after " << argument << ", got " << value << std::endl;
+                return 1;
+            }
+            if (argument == "--generations")
+            {
+                generationCount = (uint64_t)number;
+            }
+            else
+            {
+                (argument == "--width" ? columnCount : rowCount) = (int)number;
+            }
+        }
+        else
+        {
+            std::cout << "Unknown argument: " << argument << ", " << usage << std::endl;
+            return 1;
+        }
+    }
+    if (inputFilepath.empty())
+    {
+        std::cout << "No pattern given, " << usage << std::endl;
+        return 1;
+    }
+    if (isWindowGiven && (!MacrocellFile::isMacrocell(inputFilepath) || columnCount == 0 || rowCount == 0))
+    {
+        std::cout << "Windows can only be loaded from macrocell patterns and need the board size given with --width and --height" << std::endl;
+        return 1;
+    }
+    if (engineId == "hashlife" && MacrocellFile::isMacrocell(inputFilepath) && !isWindowGiven)
+    {
+        //whole universe goes into HashLife, so there is no board a size could be given to
+        if (columnCount > 0 || rowCount > 0)
+        {
+            std::cout << "Macrocell patterns run with HashLife are loaded as an unbounded universe, so --width and --height cannot be used, "
+                         "add --window left,top to run a window of the board size instead" << std::endl;
+            return 1;
+        }
+        return runMacrocellPatternInHashLife(inputFilepath, outputFilepath, generationCount, rule, isRuleGiven, topology, topologyName);
+    }
+
+    //window of a macrocell universe is the whole board, so the pattern is never moved or cut
+    CellGrid pattern(isWindowGiven ? columnCount : 1, isWindowGiven ? rowCount : 1);
+    LifeRule patternRule = rule;
+    bool isPatternLoaded = isWindowGiven ? MacrocellFile::loadWindow(inputFilepath, windowLeft, windowTop, pattern, patternRule)
+                                         : PatternFile::load(inputFilepath, pattern, patternRule);
+    if (!isPatternLoaded)
+    {
+        return 1;
+    }
+    if (!isRuleGiven)
+    {
+        rule = patternRule;
+    }
+    //pattern is placed in the middle of the board, boards smaller than the pattern cut it
+    columnCount = columnCount > 0 ? columnCount : pattern.getColumnCount();
+    rowCount = rowCount > 0 ? rowCount : pattern.getRowCount();
+    if (columnCount == 0 || rowCount == 0)
+    {
+        std::cout << "Pattern " << inputFilepath << " is empty, give the board size with --width and --height" << std::endl;
+        return 1;
+    }
+    CellGrid cellGrid(columnCount, rowCount);
+    int columnOffset = (columnCount-pattern.getColumnCount())/2;
+    int rowOffset = (rowCount-pattern.getRowCount())/2;
+    for (int column=0; column<pattern.getColumnCount(); column++)
+    {
+        for (int row=0; row<pattern.getRowCount(); row++)
+        {
+            //dying states of a Generations pattern run with a rule having fewer states are dead
+            int cellValue = pattern.getCellValue(column, row);
+            if (cellGrid.containsCell(column+columnOffset, row+rowOffset) && cellValue < rule.stateCount)
+            {
+                cellGrid.setCellValue(column+columnOffset, row+rowOffset, cellValue);
+            }
+        }
+    }
+
+    //without an explicit choice the first engine able to simulate the rule is used, same as in the interactive version
+    std::unique_ptr<CellEngine> cellEngine;
+    if (!engineId.empty())
+    {
+        cellEngine = CellEngineFactory::createEngine(engineId);
+        if (cellEngine == nullptr)
+        {
+            std::cout << "Unknown cell engine: " << engineId << ", see --list-engines" << std::endl;
+            return 1;
+        }
+        if (!cellEngine->isRuleSupported(rule))
+        {
+            std::cout << "Cell engine " << cellEngine->getName() << " does not support rule " << rule.toString() << std::endl;
+            return 1;
+        }
+        if (!cellEngine->isTopologySupported(topology))
+        {
+            std::cout << "Cell engine " << cellEngine->getName() << " simulates an unbounded universe and does not support topology " << topologyName << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        for (const std::string& availableEngineId : CellEngineFactory::getEngineIds())
+        {
+            cellEngine = CellEngineFactory::createEngine(availableEngineId);
+            if (cellEngine->isRuleSupported(rule) && cellEngine->isTopologySupported(topology))
+            {
+                break;
+            }
+        }
+    }
+    cellEngine->setTopology(topology);
+    cellEngine->setRule(rule);
+    cellEngine->setCells(cellGrid);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (HashLifeEngine* hashLifeEngine = dynamic_cast<HashLifeEngine*>(cellEngine.get()))
+    {
+        hashLifeEngine->advanceByGenerations(generationCount);
+    }
+    else
+    {
+        //other engines take an int, so long runs are split
+        uint64_t remainingGenerationCount = generationCount;
+        while (remainingGenerationCount > 0)
+        {
+            int stepGenerationCount = (int)std::min<uint64_t>(remainingGenerationCount, INT_MAX);
+            cellEngine->calculateNextGenerations(stepGenerationCount);
+            remainingGenerationCount -= stepGenerationCount;
+        }
+    }
+    cellEngine->finish();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    cellEngine->getCells(cellGrid);
+
+    double seconds = std::chrono::duration<double>(end-begin).count();
+    long long population = 0;
+    for (int column=0; column<cellGrid.getColumnCount(); column++)
+    {
+        for (int row=0; row<cellGrid.getRowCount(); row++)
+        {
+            population += cellGrid.getCellValue(column, row) == 1;
+        }
+    }
+    std::cout << "Cell engine: " << cellEngine->getName() << std::endl;
+    std::cout << "Rule: " << rule.toString() << std::endl;
+    std::cout << "Board: " << cellGrid.getColumnCount() << "x" << cellGrid.getRowCount() << ", generations: " << generationCount << std::endl;
+    std::cout << "Time: " << seconds << " s";
+    if (seconds > 0)
+    {
+        std::cout << ", " << (double)cellGrid.getColumnCount()*cellGrid.getRowCount()*generationCount/seconds << " cell updates per second";
+    }
+    std::cout << std::endl;
+    std::cout << "Population: " << population << std::endl;
+    if (SparseCellEngine* sparseCellEngine = dynamic_cast<SparseCellEngine*>(cellEngine.get()))
+    {
+        std::cout << "Skipped tiles: " << sparseCellEngine->getTotalSkippedTileCount() << " of " << (uint64_t)sparseCellEngine->getTileCount()*generationCount
+                  << ", " << sparseCellEngine->getSkippedTileCount() << " of " << sparseCellEngine->getTileCount() << " in the last generation" << std::endl;
+    }
+    if (ChunkedCellEngine* chunkedCellEngine = dynamic_cast<ChunkedCellEngine*>(cellEngine.get()))
+    {
+        std::cout << "Chunks: " << chunkedCellEngine->getChunkCount() << std::endl;
+    }
+
+    if (!outputFilepath.empty() && !PatternFile::save(outputFilepath, cellGrid, rule))
+    {
+        return 1;
+    }
+    return 0;
+}
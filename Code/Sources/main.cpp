@@ -1,8 +1,51 @@
 #include "../Headers/Game.h"
 
-int main()
+int main(int argc, char* argv[])
 {
-    Game game1 = Game();
+    //any Life-like, Generations or Larger than Life rule can be chosen on startup, for example: GameOfLife --rule B36/S23, GameOfLife --rule B2/S/C3
+    //or GameOfLife --rule R5,C0,M1,S34..58,B34..45,NM
+    LifeRule rule = LifeRule::conway();
+    bool isRuleGiven = false;//rule given on the command line wins over the one named by the pattern file
+    std::string patternFilepath;
+    for (int i=1; i<argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--rule" && i+1 < argc)
+        {
+            if (!LifeRule::parse(argv[++i], rule))
+            {
+                std::cout << "Invalid rule: " << argv[i] << ", expected B/S, B/S/C or Larger than Life notation such as B3/S23, B2/S345/C4 or R5,C0,M1,S34..58,B34..45,NM" << std::endl;
+                return 1;
+            }
+            isRuleGiven = true;
+        }
+        else if (argument == "--pattern" && i+1 < argc)
+        {
+            patternFilepath = argv[++i];
+        }
+        else
+        {
+            std::cout << "Unknown argument: " << argument << ", usage: GameOfLife [--rule B3/S23 | --rule B2/S/C3] [--pattern pattern.rle]" << std::endl;
+            return 1;
+        }
+    }
+
+    //pattern is loaded before any window opens, so a broken file is reported right away
+    CellGrid pattern(1, 1);
+    if (!patternFilepath.empty())
+    {
+        LifeRule patternRule = rule;
+        if (!PatternFile::load(patternFilepath, pattern, patternRule))
+        {
+            return 1;
+        }
+        if (!isRuleGiven)
+        {
+            rule = patternRule;
+        }
+    }
+
+    Game game1 = Game(rule, patternFilepath.empty() ? nullptr : &pattern);
     game1.run();
     return 0;
 }
@@ -0,0 +1,18 @@
+uniform sampler2D stateTexture;
+uniform sampler2D cellAtlasTexture;
+uniform vec2 boardSize;
+uniform float stateCount;
+
+void main()
+{
+    //every texel of the state texture covers a whole cell, position inside that cell picks the texel of the cell image
+    vec2 boardPosition = gl_TexCoord[0].xy*boardSize;
+    vec2 positionInCell = fract(boardPosition);
+    float state = floor(texture2D(stateTexture, (floor(boardPosition)+0.5)/boardSize).r*255.0+0.5);
+
+    //atlas holds dead cell image on its left half and alive cell image on its right half, dying states of Generations rules
+    //use the alive image fading to a quarter of its brightness (same formula as CellRenderer::getCellBrightness)
+    float atlasHalf = state > 0.5 ? 1.0 : 0.0;
+    float brightness = state > 1.5 ? 1.0-0.75*(state-1.0)/(stateCount-1.0) : 1.0;
+    gl_FragColor = gl_Color*vec4(vec3(brightness), 1.0)*texture2D(cellAtlasTexture, vec2((positionInCell.x+atlasHalf)*0.5, positionInCell.y));
+}